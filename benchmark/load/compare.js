@@ -0,0 +1,46 @@
+import fs from 'fs'
+
+// Compares two results files written by index.js, case by case:
+//   node load/compare.js before.json after.json
+
+const [beforeFile, afterFile] = process.argv.slice(2)
+
+if (!beforeFile || !afterFile) {
+  console.error('Usage: node load/compare.js <before.json> <after.json>')
+  process.exit(1)
+}
+
+const read = (file) => JSON.parse(fs.readFileSync(file, 'utf8'))
+const before = read(beforeFile)
+const after = read(afterFile)
+
+const key = ({ layer, protocol, concurrency, size }) =>
+  `${layer} ${protocol} c=${concurrency} size=${size}`
+
+const beforeResults = new Map(
+  before.results.map((result) => [key(result), result]),
+)
+
+const change = (from, to) =>
+  from && to !== null ? `${(((to - from) / from) * 100).toFixed(1)}%` : '-'
+
+console.log(`before: ${before.date} ${before.libcurl}`)
+console.log(`after:  ${after.date} ${after.libcurl}\n`)
+
+const rows = {}
+
+for (const result of after.results) {
+  const previous = beforeResults.get(key(result))
+  if (!previous) continue
+
+  rows[key(result)] = {
+    'req/s': change(previous.requestsPerSec, result.requestsPerSec),
+    p50: change(previous.latencyMs.p50, result.latencyMs.p50),
+    p99: change(previous.latencyMs.p99, result.latencyMs.p99),
+    p999: change(previous.latencyMs.p999, result.latencyMs.p999),
+    'cpu/req': change(previous.cpuUsPerRequest, result.cpuUsPerRequest),
+    'peak rss': change(previous.rss.peak, result.rss.peak),
+  }
+}
+
+console.table(rows)
@@ -0,0 +1,393 @@
+import { fork } from 'child_process'
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+import { fileURLToPath } from 'url'
+import { parseArgs } from 'util'
+
+import { createRequire } from 'module'
+const require = createRequire(import.meta.url)
+const {
+  curly,
+  Curl,
+  CurlCode,
+  CurlFeature,
+  CurlHttpVersion,
+  CurlPipe,
+  Easy,
+  Multi,
+} = require('../../dist')
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url))
+
+const { values: args } = parseArgs({
+  options: {
+    layers: { type: 'string', default: 'easy,multi,curl,curly' },
+    protocols: { type: 'string', default: 'http1,h2c,https' },
+    concurrency: { type: 'string', default: '1,10,100,1000' },
+    sizes: { type: 'string', default: '0,1k,64k,1m' },
+    // 10k concurrent transfers and 100 MB bodies
+    full: { type: 'boolean', default: false },
+    // requests per case, defaults to enough for the p999 to mean something
+    requests: { type: 'string' },
+    // cases transferring more than this are run with fewer requests
+    'max-bytes': { type: 'string', default: '1g' },
+    // cases keeping more than this in memory at once are skipped
+    'max-inflight-bytes': { type: 'string', default: '2g' },
+    output: { type: 'string' },
+  },
+})
+
+const parseSize = (value) => {
+  const match = /^(\d+(?:\.\d+)?)([kmg]?)b?$/i.exec(value.trim())
+  if (!match) throw new Error(`Invalid size: ${value}`)
+
+  const units = { '': 1, k: 1024, m: 1024 ** 2, g: 1024 ** 3 }
+  return Math.round(parseFloat(match[1]) * units[match[2].toLowerCase()])
+}
+
+const parseList = (value, parse = (item) => item) =>
+  value
+    .split(',')
+    .map((item) => item.trim())
+    .filter(Boolean)
+    .map(parse)
+
+const layers = parseList(args.layers)
+const protocols = parseList(args.protocols)
+const concurrencies = args.full
+  ? [1, 10, 100, 1000, 10000]
+  : parseList(args.concurrency, (item) => parseInt(item, 10))
+const sizes = args.full
+  ? [0, 1024, 64 * 1024, 1024 ** 2, 100 * 1024 ** 2]
+  : parseList(args.sizes, parseSize)
+const maxBytes = parseSize(args['max-bytes'])
+const maxInflightBytes = parseSize(args['max-inflight-bytes'])
+
+const protocolOptions = {
+  http1: { scheme: 'http', httpVersion: CurlHttpVersion.V1_1 },
+  h2c: { scheme: 'http', httpVersion: CurlHttpVersion.V2PriorKnowledge },
+  https: { scheme: 'https', httpVersion: CurlHttpVersion.V1_1 },
+}
+
+// Set on every handle, the self signed certificate of the servers is trusted
+const handleOptions = (url, protocol) => ({
+  URL: url,
+  HTTP_VERSION: protocolOptions[protocol].httpVersion,
+  SSL_VERIFYPEER: false,
+  SSL_VERIFYHOST: 0,
+})
+
+const setOptions = (handle, options) => {
+  for (const [option, value] of Object.entries(options)) {
+    handle.setOpt(option, value)
+  }
+}
+
+const createEasy = (url, protocol) => {
+  const easy = new Easy()
+  setOptions(easy, handleOptions(url, protocol))
+  // the body is discarded, but still goes through a JS callback
+  easy.setOpt('WRITEFUNCTION', (data, size, nmemb) => size * nmemb)
+  return easy
+}
+
+// Each layer creates a client per worker, which calls request() in a loop
+const layerFactories = {
+  // Easy#perform blocks, so there is no concurrency with it
+  easy: {
+    maxConcurrency: 1,
+    create: (url, protocol) => {
+      const easy = createEasy(url, protocol)
+
+      return {
+        request: async () => {
+          const code = easy.perform()
+          if (code !== CurlCode.CURLE_OK) {
+            throw new Error(Easy.strError(code))
+          }
+        },
+        close: () => easy.close(),
+      }
+    },
+  },
+
+  multi: {
+    create: (url, protocol, shared) => {
+      if (!shared.multi) {
+        shared.multi = new Multi()
+        shared.multi.setOpt('PIPELINING', CurlPipe.Multiplex)
+      }
+
+      const easy = createEasy(url, protocol)
+
+      return {
+        request: async () => {
+          try {
+            await shared.multi.perform(easy)
+          } finally {
+            // the Multi handle does not remove finished handles, and it cannot be done
+            // from inside its callbacks, see https://github.com/JCMais/node-libcurl/issues/439
+            await new Promise((resolve) => setImmediate(resolve))
+            if (easy.isInsideMultiHandle) shared.multi.removeHandle(easy)
+          }
+        },
+        close: () => easy.close(),
+      }
+    },
+    closeShared: (shared) => shared.multi?.close(),
+  },
+
+  curl: {
+    create: (url, protocol) => {
+      const curl = new Curl()
+      curl.enable(CurlFeature.NoStorage)
+      setOptions(curl, handleOptions(url, protocol))
+
+      return {
+        request: () =>
+          new Promise((resolve, reject) => {
+            const onEnd = () => {
+              curl.off('error', onError)
+              resolve()
+            }
+            const onError = (error) => {
+              curl.off('end', onEnd)
+              reject(error)
+            }
+
+            curl.once('end', onEnd)
+            curl.once('error', onError)
+            curl.perform()
+          }),
+        close: () => curl.close(),
+      }
+    },
+  },
+
+  // the body is kept in memory, as curly always stores it
+  curly: {
+    storesBody: true,
+    create: (url, protocol) => {
+      const { httpVersion } = protocolOptions[protocol]
+
+      return {
+        request: async () => {
+          await curly.get(url, {
+            httpVersion,
+            sslVerifyPeer: false,
+            sslVerifyHost: 0,
+            curlyResponseBodyParser: false,
+          })
+        },
+        close: () => {},
+      }
+    },
+  },
+}
+
+// nearest rank, values must be sorted
+const percentile = (values, p) =>
+  values.length
+    ? values[Math.min(values.length - 1, Math.ceil(p * values.length) - 1)]
+    : null
+
+async function runCase({ layer, protocol, concurrency, size, url }) {
+  const factory = layerFactories[layer]
+
+  const requests = Math.max(
+    concurrency,
+    Math.min(
+      args.requests
+        ? parseInt(args.requests, 10)
+        : Math.max(1000, concurrency * 10),
+      size ? Math.floor(maxBytes / size) : Infinity,
+    ),
+  )
+
+  const shared = {}
+  const clients = Array.from({ length: concurrency }, () =>
+    factory.create(url, protocol, shared),
+  )
+
+  const runWorkers = async (total, onDone) => {
+    let issued = 0
+
+    await Promise.all(
+      clients.map(async (client) => {
+        while (issued < total) {
+          issued++
+          const start = process.hrtime.bigint()
+
+          try {
+            await client.request()
+            onDone(Number(process.hrtime.bigint() - start) / 1e6, null)
+          } catch (error) {
+            onDone(null, error)
+          }
+        }
+      }),
+    )
+  }
+
+  // warm up the connections, each worker does one request
+  await runWorkers(concurrency, () => {})
+
+  global.gc?.()
+  const rssBefore = process.memoryUsage.rss()
+  let rssPeak = rssBefore
+  const rssTimer = setInterval(() => {
+    rssPeak = Math.max(rssPeak, process.memoryUsage.rss())
+  }, 20)
+
+  const latencies = new Float64Array(requests)
+  let completed = 0
+  let failed = 0
+  let firstError = null
+
+  const cpuStart = process.cpuUsage()
+  const start = process.hrtime.bigint()
+
+  await runWorkers(requests, (latency, error) => {
+    if (error) {
+      failed++
+      firstError ??= error
+    } else {
+      latencies[completed++] = latency
+    }
+  })
+
+  const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6
+  const cpu = process.cpuUsage(cpuStart)
+
+  clearInterval(rssTimer)
+  rssPeak = Math.max(rssPeak, process.memoryUsage.rss())
+
+  for (const client of clients) client.close()
+  factory.closeShared?.(shared)
+
+  const sorted = latencies.subarray(0, completed).sort()
+
+  return {
+    layer,
+    protocol,
+    concurrency,
+    size,
+    requests: completed,
+    failed,
+    error: firstError ? String(firstError.message ?? firstError) : undefined,
+    elapsedMs,
+    requestsPerSec: completed / (elapsedMs / 1000),
+    bytesPerSec: (completed * size) / (elapsedMs / 1000),
+    latencyMs: {
+      min: sorted[0] ?? null,
+      p50: percentile(sorted, 0.5),
+      p90: percentile(sorted, 0.9),
+      p99: percentile(sorted, 0.99),
+      p999: percentile(sorted, 0.999),
+      max: sorted[sorted.length - 1] ?? null,
+    },
+    cpuUsPerRequest: completed ? (cpu.user + cpu.system) / completed : null,
+    rss: { before: rssBefore, peak: rssPeak },
+  }
+}
+
+const startServers = () =>
+  new Promise((resolve, reject) => {
+    const child = fork(path.join(__dirname, 'servers.js'), {
+      stdio: 'inherit',
+    })
+    child.once('message', (message) => resolve({ child, ...message }))
+    child.once('error', reject)
+    child.once('exit', (code) =>
+      reject(new Error(`The servers exited with code ${code}`)),
+    )
+  })
+
+const formatBytes = (bytes) => {
+  if (bytes >= 1024 ** 2) return `${(bytes / 1024 ** 2).toFixed(1)} MiB`
+  if (bytes >= 1024) return `${(bytes / 1024).toFixed(1)} KiB`
+  return `${bytes} B`
+}
+
+const formatMs = (value) => (value === null ? '-' : value.toFixed(3))
+
+const { child, host, ports } = await startServers()
+
+console.log(Curl.getVersion())
+
+const results = []
+const skipped = []
+
+for (const protocol of protocols) {
+  if (!ports[protocol]) {
+    throw new Error(`Unknown protocol: ${protocol}`)
+  }
+
+  for (const layer of layers) {
+    const factory = layerFactories[layer]
+    if (!factory) throw new Error(`Unknown layer: ${layer}`)
+
+    for (const concurrency of concurrencies) {
+      for (const size of sizes) {
+        const testCase = { layer, protocol, concurrency, size }
+        const name = `${layer} ${protocol} c=${concurrency} ${formatBytes(size)}`
+        const { scheme } = protocolOptions[protocol]
+        const url = `${scheme}://${host}:${ports[protocol]}/bytes/${size}`
+
+        if (concurrency > (factory.maxConcurrency ?? Infinity)) {
+          skipped.push({ ...testCase, reason: 'blocking' })
+          continue
+        }
+
+        if (factory.storesBody && concurrency * size > maxInflightBytes) {
+          skipped.push({ ...testCase, reason: 'memory' })
+          continue
+        }
+
+        const result = await runCase({ ...testCase, url })
+        results.push(result)
+
+        const requestsPerSec = result.requestsPerSec.toFixed(0)
+        console.log(
+          `${name.padEnd(40)} ${requestsPerSec.padStart(8)} req/s` +
+            `  p50 ${formatMs(result.latencyMs.p50)}ms` +
+            `  p99 ${formatMs(result.latencyMs.p99)}ms` +
+            `  p999 ${formatMs(result.latencyMs.p999)}ms` +
+            `  cpu ${(result.cpuUsPerRequest ?? 0).toFixed(1)}us/req` +
+            `  rss ${formatBytes(result.rss.peak)}` +
+            (result.failed ? `  failed ${result.failed}: ${result.error}` : ''),
+        )
+      }
+    }
+  }
+}
+
+child.disconnect()
+
+const report = {
+  date: new Date().toISOString(),
+  libcurl: Curl.getVersion(),
+  node: process.version,
+  platform: `${process.platform} ${process.arch}`,
+  cpus: `${os.cpus().length}x ${os.cpus()[0]?.model ?? 'unknown'}`,
+  memory: os.totalmem(),
+  options: {
+    layers,
+    protocols,
+    concurrencies,
+    sizes,
+    maxBytes,
+    maxInflightBytes,
+    requests: args.requests ? parseInt(args.requests, 10) : undefined,
+  },
+  results,
+  skipped,
+}
+
+const output =
+  args.output ??
+  path.join(__dirname, `results-${report.date.replace(/[:.]/g, '-')}.json`)
+fs.writeFileSync(output, JSON.stringify(report, null, 2))
+
+console.log(`\nResults written to ${output}`)
@@ -0,0 +1,418 @@
+import { fork } from 'child_process'
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+import { fileURLToPath } from 'url'
+import { parseArgs } from 'util'
+
+import { createRequire } from 'module'
+const require = createRequire(import.meta.url)
+const {
+  curly,
+  Curl,
+  CurlCode,
+  CurlFeature,
+  CurlHttpVersion,
+  Easy,
+  TraceCallback,
+  TraceEvent,
+} = require('../../dist')
+
+const __filename = fileURLToPath(import.meta.url)
+const __dirname = path.dirname(__filename)
+
+const { values: args } = parseArgs({
+  options: {
+    paths: {
+      type: 'string',
+      default:
+        'easy,curl-buffered,curl-stream,curly,curly-stream,upload-readdata,upload-stream',
+    },
+    sizes: { type: 'string', default: '100m,1g' },
+    // 100 MB up to 10 GB
+    full: { type: 'boolean', default: false },
+    protocol: { type: 'string', default: 'http1' },
+    // the paths keeping the whole body in memory are skipped above this
+    'max-buffered': { type: 'string', default: '2g' },
+    output: { type: 'string' },
+    // internal, the case run by a child process
+    case: { type: 'string' },
+  },
+})
+
+const MiB = 1024 * 1024
+
+const parseSize = (value) => {
+  const match = /^(\d+(?:\.\d+)?)([kmg]?)b?$/i.exec(value.trim())
+  if (!match) throw new Error(`Invalid size: ${value}`)
+
+  const units = { '': 1, k: 1024, m: MiB, g: 1024 * MiB }
+  return Math.round(parseFloat(match[1]) * units[match[2].toLowerCase()])
+}
+
+const httpVersions = {
+  http1: CurlHttpVersion.V1_1,
+  h2c: CurlHttpVersion.V2PriorKnowledge,
+  https: CurlHttpVersion.V1_1,
+}
+
+const setCommonOptions = (handle, url, protocol) => {
+  handle.setOpt('URL', url)
+  handle.setOpt('HTTP_VERSION', httpVersions[protocol])
+  handle.setOpt('SSL_VERIFYPEER', false)
+  handle.setOpt('SSL_VERIFYHOST', 0)
+}
+
+const performCurl = (curl, onEnd = () => {}) =>
+  new Promise((resolve, reject) => {
+    curl.on('end', (status, data) => {
+      onEnd(data)
+      curl.close()
+      resolve()
+    })
+    curl.on('error', (error) => {
+      curl.close()
+      reject(error)
+    })
+    curl.perform()
+  })
+
+const consumeStream = (stream) =>
+  new Promise((resolve, reject) => {
+    let received = 0
+    stream.on('data', (data) => {
+      received += data.length
+    })
+    stream.on('end', () => resolve(received))
+    stream.on('error', reject)
+  })
+
+// Each path transfers size bytes, and returns how many were transferred.
+const paths = {
+  easy: {
+    direction: 'download',
+    run: async ({ url, protocol }) => {
+      const easy = new Easy()
+      let received = 0
+
+      setCommonOptions(easy, url, protocol)
+      easy.setOpt('WRITEFUNCTION', (data, size, nmemb) => {
+        received += data.length
+        return size * nmemb
+      })
+
+      const code = easy.perform()
+      easy.close()
+
+      if (code !== CurlCode.CURLE_OK) throw new Error(Easy.strError(code))
+      return received
+    },
+  },
+
+  'curl-buffered': {
+    direction: 'download',
+    buffered: true,
+    run: async ({ url, protocol }) => {
+      const curl = new Curl()
+      let received = 0
+
+      setCommonOptions(curl, url, protocol)
+      // the chunks are merged into a single Buffer when the transfer ends
+      curl.enable(CurlFeature.NoDataParsing)
+      await performCurl(curl, (data) => {
+        received = data.length
+      })
+
+      return received
+    },
+  },
+
+  'curl-stream': {
+    direction: 'download',
+    run: async ({ url, protocol }) => {
+      const curl = new Curl()
+
+      setCommonOptions(curl, url, protocol)
+      curl.enable(CurlFeature.StreamResponse)
+
+      const [received] = await Promise.all([
+        new Promise((resolve, reject) => {
+          curl.on('stream', (stream) =>
+            consumeStream(stream).then(resolve, reject),
+          )
+          curl.on('error', reject)
+        }),
+        performCurl(curl),
+      ])
+
+      return received
+    },
+  },
+
+  curly: {
+    direction: 'download',
+    buffered: true,
+    run: async ({ url, protocol }) => {
+      const { data } = await curly.get(url, {
+        httpVersion: httpVersions[protocol],
+        sslVerifyPeer: false,
+        sslVerifyHost: 0,
+        curlyResponseBodyParser: false,
+      })
+
+      return data.length
+    },
+  },
+
+  'curly-stream': {
+    direction: 'download',
+    run: async ({ url, protocol }) => {
+      const { data } = await curly.get(url, {
+        httpVersion: httpVersions[protocol],
+        sslVerifyPeer: false,
+        sslVerifyHost: 0,
+        curlyStreamResponse: true,
+      })
+
+      return consumeStream(data)
+    },
+  },
+
+  // libcurl reads the file itself, with no JS callbacks
+  'upload-readdata': {
+    direction: 'upload',
+    run: async ({ url, protocol, file, size }) => {
+      const easy = new Easy()
+      const fd = fs.openSync(file, 'r')
+      let response = ''
+
+      setCommonOptions(easy, url, protocol)
+      easy.setOpt('UPLOAD', true)
+      easy.setOpt('READDATA', fd)
+      easy.setOpt('INFILESIZE_LARGE', size)
+      easy.setOpt('WRITEFUNCTION', (data, size, nmemb) => {
+        response += data.toString()
+        return size * nmemb
+      })
+
+      const code = easy.perform()
+      easy.close()
+      fs.closeSync(fd)
+
+      if (code !== CurlCode.CURLE_OK) throw new Error(Easy.strError(code))
+      return parseInt(response, 10)
+    },
+  },
+
+  'upload-stream': {
+    direction: 'upload',
+    run: async ({ url, protocol, file, size }) => {
+      const curl = new Curl()
+      let received = 0
+
+      setCommonOptions(curl, url, protocol)
+      curl.setOpt('UPLOAD', true)
+      curl.setOpt('INFILESIZE_LARGE', size)
+      curl.setUploadStream(
+        fs.createReadStream(file, { highWaterMark: 64 * 1024 }),
+      )
+
+      await performCurl(curl, (data) => {
+        received = parseInt(data, 10)
+      })
+
+      return received
+    },
+  },
+}
+
+// Runs a single case, in its own process, so the peak RSS is only of this case.
+async function runCase(testCase) {
+  const { path: pathName, size } = testCase
+  const transferPath = paths[pathName]
+
+  // every call of a JS callback by the addon is recorded, and counted here
+  Curl.setTraceEnabled(true, 1 << 20)
+  Curl.drainTrace()
+
+  const callbacks = {}
+  let dropped = 0
+  const countCallbacks = () => {
+    const snapshot = Curl.drainTrace()
+    dropped += snapshot.dropped
+
+    for (const record of snapshot.records) {
+      if (record.event !== TraceEvent.EasyCallback) continue
+
+      const name = TraceCallback[record.value] ?? `${record.value}`
+      callbacks[name] = (callbacks[name] ?? 0) + 1
+    }
+  }
+  const traceTimer = setInterval(countCallbacks, 100)
+
+  const cpuStart = process.cpuUsage()
+  const start = process.hrtime.bigint()
+
+  const transferred = await transferPath.run(testCase)
+
+  const seconds = Number(process.hrtime.bigint() - start) / 1e9
+  const cpu = process.cpuUsage(cpuStart)
+
+  clearInterval(traceTimer)
+  countCallbacks()
+  Curl.setTraceEnabled(false)
+
+  if (transferred !== size) {
+    throw new Error(`Transferred ${transferred} bytes, expected ${size}`)
+  }
+
+  const totalCallbacks = Object.values(callbacks).reduce((a, b) => a + b, 0)
+
+  return {
+    path: pathName,
+    direction: transferPath.direction,
+    protocol: testCase.protocol,
+    size,
+    seconds,
+    mibPerSec: size / MiB / seconds,
+    cpuSeconds: {
+      user: cpu.user / 1e6,
+      system: cpu.system / 1e6,
+      total: (cpu.user + cpu.system) / 1e6,
+    },
+    // maxRSS is in kilobytes
+    peakRss: process.resourceUsage().maxRSS * 1024,
+    callbacks: {
+      total: totalCallbacks,
+      perMib: totalCallbacks / (size / MiB),
+      byType: callbacks,
+      // if not 0, the counts above are lower than they should be
+      droppedTraceRecords: dropped,
+    },
+  }
+}
+
+if (args.case) {
+  const result = await runCase(JSON.parse(args.case))
+  process.send(result, () => process.exit(0))
+}
+
+const startServers = () =>
+  new Promise((resolve, reject) => {
+    const child = fork(path.join(__dirname, 'servers.js'), {
+      stdio: 'inherit',
+    })
+    child.once('message', (message) => resolve({ child, ...message }))
+    child.once('error', reject)
+  })
+
+const forkCase = (testCase) =>
+  new Promise((resolve, reject) => {
+    let result = null
+    const child = fork(__filename, ['--case', JSON.stringify(testCase)], {
+      stdio: 'inherit',
+    })
+    child.once('message', (message) => {
+      result = message
+    })
+    child.once('error', reject)
+    child.once('exit', (code) =>
+      result
+        ? resolve(result)
+        : reject(new Error(`The case exited with code ${code}`)),
+    )
+  })
+
+const pathNames = args.paths.split(',').map((item) => item.trim())
+const sizes = args.full
+  ? [100 * MiB, 1024 * MiB, 10 * 1024 * MiB]
+  : args.sizes.split(',').map(parseSize)
+const maxBuffered = Math.min(
+  parseSize(args['max-buffered']),
+  require('buffer').constants.MAX_LENGTH,
+)
+const { protocol } = args
+
+for (const name of pathNames) {
+  if (!paths[name]) throw new Error(`Unknown path: ${name}`)
+}
+
+const { child, host, ports } = await startServers()
+if (!ports[protocol]) throw new Error(`Unknown protocol: ${protocol}`)
+
+const scheme = protocol === 'https' ? 'https' : 'http'
+const baseUrl = `${scheme}://${host}:${ports[protocol]}`
+
+console.log(Curl.getVersion())
+
+// uploaded by the upload paths, sparse, so creating it is instant
+const uploadFile = path.join(
+  os.tmpdir(),
+  `node-libcurl-large-body-${process.pid}.bin`,
+)
+
+const results = []
+const skipped = []
+
+try {
+  for (const size of sizes) {
+    if (pathNames.some((name) => paths[name].direction === 'upload')) {
+      fs.closeSync(fs.openSync(uploadFile, 'w'))
+      fs.truncateSync(uploadFile, size)
+    }
+
+    for (const name of pathNames) {
+      if (paths[name].buffered && size > maxBuffered) {
+        skipped.push({ path: name, size, reason: 'buffered' })
+        continue
+      }
+
+      const url =
+        paths[name].direction === 'upload'
+          ? `${baseUrl}/upload`
+          : `${baseUrl}/bytes/${size}`
+
+      const result = await forkCase({
+        path: name,
+        protocol,
+        size,
+        url,
+        file: uploadFile,
+      })
+      results.push(result)
+
+      console.log(
+        `${name.padEnd(16)} ${`${size / MiB} MiB`.padStart(10)}` +
+          `  ${result.mibPerSec.toFixed(1).padStart(8)} MiB/s` +
+          `  cpu ${result.cpuSeconds.total.toFixed(2)}s` +
+          `  rss ${(result.peakRss / MiB).toFixed(0)} MiB` +
+          `  ${result.callbacks.perMib.toFixed(1)} callbacks/MiB`,
+      )
+    }
+  }
+} finally {
+  fs.rmSync(uploadFile, { force: true })
+  child.disconnect()
+}
+
+const report = {
+  date: new Date().toISOString(),
+  libcurl: Curl.getVersion(),
+  node: process.version,
+  platform: `${process.platform} ${process.arch}`,
+  cpus: `${os.cpus().length}x ${os.cpus()[0]?.model ?? 'unknown'}`,
+  memory: os.totalmem(),
+  options: { paths: pathNames, sizes, protocol, maxBuffered },
+  results,
+  skipped,
+}
+
+const output =
+  args.output ??
+  path.join(
+    __dirname,
+    `results-large-${report.date.replace(/[:.]/g, '-')}.json`,
+  )
+fs.writeFileSync(output, JSON.stringify(report, null, 2))
+
+console.log(`\nResults written to ${output}`)
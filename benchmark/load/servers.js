@@ -0,0 +1,101 @@
+import fs from 'fs'
+import http from 'http'
+import http2 from 'http2'
+import https from 'https'
+import path from 'path'
+import { fileURLToPath } from 'url'
+
+// Started by the benchmarks in a separate process, so the work done by the
+// servers does not count towards the CPU time and memory of the client.
+// Every server replies to /bytes/<size> with a body of that size, and to
+// /upload with the number of bytes received.
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url))
+const sslDir = path.resolve(__dirname, '../../test/helper/ssl')
+
+const HOST = process.env.HOST || '127.0.0.1'
+
+const chunk = Buffer.alloc(1024 * 1024, 'a')
+
+function upload(req, res) {
+  let received = 0
+
+  req.on('data', (data) => {
+    received += data.length
+  })
+  req.on('end', () => {
+    res.writeHead(200, { 'content-type': 'text/plain' })
+    res.end(`${received}`)
+  })
+}
+
+function handler(req, res) {
+  if (req.url === '/upload') {
+    upload(req, res)
+    return
+  }
+
+  const match = /^\/bytes\/(\d+)$/.exec(req.url)
+  if (!match) {
+    res.writeHead(404)
+    res.end()
+    return
+  }
+
+  let remaining = parseInt(match[1], 10)
+
+  res.writeHead(200, {
+    'content-type': 'application/octet-stream',
+    'content-length': remaining,
+  })
+
+  const write = () => {
+    while (remaining > 0) {
+      const length = Math.min(remaining, chunk.length)
+      remaining -= length
+
+      const flushed = res.write(
+        length === chunk.length ? chunk : chunk.subarray(0, length),
+      )
+      if (!flushed) {
+        res.once('drain', write)
+        return
+      }
+    }
+
+    res.end()
+  }
+
+  write()
+}
+
+const servers = {
+  http1: http.createServer({ keepAliveTimeout: 60_000 }, handler),
+  h2c: http2.createServer({}, handler),
+  https: https.createServer(
+    {
+      key: fs.readFileSync(path.join(sslDir, 'cert.key')),
+      cert: fs.readFileSync(path.join(sslDir, 'cert.pem')),
+      keepAliveTimeout: 60_000,
+    },
+    handler,
+  ),
+}
+
+const listen = (server) =>
+  new Promise((resolve, reject) => {
+    server.once('error', reject)
+    // the default backlog is not enough for thousands of connections at once
+    server.listen({ port: 0, host: HOST, backlog: 65535 }, () =>
+      resolve(server.address().port),
+    )
+  })
+
+const ports = {}
+for (const [name, server] of Object.entries(servers)) {
+  ports[name] = await listen(server)
+}
+
+process.send({ host: HOST, ports })
+
+process.on('disconnect', () => process.exit(0))
@@ -0,0 +1,270 @@
+import { fork } from 'child_process'
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+import { fileURLToPath } from 'url'
+import { parseArgs } from 'util'
+import v8 from 'v8'
+import { Worker, isMainThread, parentPort, workerData } from 'worker_threads'
+
+import { createRequire } from 'module'
+const require = createRequire(import.meta.url)
+
+const __filename = fileURLToPath(import.meta.url)
+const __dirname = path.dirname(__filename)
+
+// nearest rank, values must be sorted
+const percentile = (values, p) =>
+  values.length
+    ? values[Math.min(values.length - 1, Math.ceil(p * values.length) - 1)]
+    : null
+
+// Each worker loads the library, so the addon creates its own instance data and
+// parses the CA certificates of Node.js, then keeps `concurrency` requests in
+// flight on its own Multi handle.
+async function workerMain() {
+  const { url, concurrency, httpVersion } = workerData
+
+  const loadStart = performance.now()
+  const { CurlHttpVersion, Easy, Multi } = require('../../dist')
+  const loadMs = performance.now() - loadStart
+
+  const setupStart = performance.now()
+  const multi = new Multi()
+  const handles = Array.from({ length: concurrency }, () => {
+    const easy = new Easy()
+    easy.setOpt('URL', url)
+    easy.setOpt('HTTP_VERSION', CurlHttpVersion[httpVersion])
+    easy.setOpt('SSL_VERIFYPEER', false)
+    easy.setOpt('SSL_VERIFYHOST', 0)
+    easy.setOpt('WRITEFUNCTION', (data, size, nmemb) => size * nmemb)
+    return easy
+  })
+  const setupMs = performance.now() - setupStart
+
+  parentPort.postMessage({
+    type: 'ready',
+    loadMs,
+    setupMs,
+    heapUsed: v8.getHeapStatistics().used_heap_size,
+  })
+
+  const { durationMs } = await new Promise((resolve) =>
+    parentPort.once('message', resolve),
+  )
+
+  const latencies = []
+  let failed = 0
+  const deadline = performance.now() + durationMs
+
+  await Promise.all(
+    handles.map(async (easy) => {
+      while (performance.now() < deadline) {
+        const start = performance.now()
+        try {
+          await multi.perform(easy)
+          latencies.push(performance.now() - start)
+        } catch {
+          failed++
+        }
+
+        // finished handles stay inside the Multi handle, and they cannot be removed
+        // from inside its callbacks, see https://github.com/JCMais/node-libcurl/issues/439
+        await new Promise((resolve) => setImmediate(resolve))
+        if (easy.isInsideMultiHandle) multi.removeHandle(easy)
+      }
+    }),
+  )
+
+  for (const easy of handles) easy.close()
+  multi.close()
+
+  parentPort.postMessage({ type: 'done', latencies, failed })
+}
+
+if (!isMainThread) {
+  await workerMain()
+} else {
+  const { values: args } = parseArgs({
+    options: {
+      workers: { type: 'string', default: '1,2,4,8,16,32' },
+      // requests in flight in each worker
+      concurrency: { type: 'string', default: '10' },
+      duration: { type: 'string', default: '5000' },
+      protocol: { type: 'string', default: 'http1' },
+      // an external server, the one started here may become the bottleneck
+      url: { type: 'string' },
+      output: { type: 'string' },
+    },
+  })
+
+  const workerCounts = args.workers.split(',').map((n) => parseInt(n, 10))
+  const concurrency = parseInt(args.concurrency, 10)
+  const durationMs = parseInt(args.duration, 10)
+  const httpVersion = args.protocol === 'h2c' ? 'V2PriorKnowledge' : 'V1_1'
+
+  const { Curl } = require('../../dist')
+  console.log(Curl.getVersion())
+
+  let servers = null
+  let url = args.url
+
+  if (!url) {
+    servers = await new Promise((resolve, reject) => {
+      const child = fork(path.join(__dirname, 'servers.js'), {
+        stdio: 'inherit',
+      })
+      child.once('message', (message) => resolve({ child, ...message }))
+      child.once('error', reject)
+    })
+
+    const { host, ports } = servers
+    if (!ports[args.protocol]) {
+      throw new Error(`Unknown protocol: ${args.protocol}`)
+    }
+
+    const scheme = args.protocol === 'https' ? 'https' : 'http'
+    url = `${scheme}://${host}:${ports[args.protocol]}/bytes/1024`
+  }
+
+  const waitFor = (worker, type) =>
+    new Promise((resolve, reject) => {
+      const onMessage = (message) => {
+        if (message.type !== type) return
+        worker.off('message', onMessage)
+        worker.off('error', reject)
+        resolve(message)
+      }
+      worker.on('message', onMessage)
+      worker.once('error', reject)
+    })
+
+  const runStep = async (count) => {
+    global.gc?.()
+    const rssBefore = process.memoryUsage.rss()
+
+    // all the workers start at once, like they would when a pool starts
+    const startupStart = performance.now()
+    const workers = Array.from({ length: count }, () => {
+      const start = performance.now()
+      const worker = new Worker(__filename, {
+        workerData: { url, concurrency, httpVersion },
+      })
+
+      return {
+        worker,
+        ready: waitFor(worker, 'ready').then((message) => ({
+          ...message,
+          startupMs: performance.now() - start,
+        })),
+      }
+    })
+
+    const ready = await Promise.all(workers.map(({ ready }) => ready))
+    const startupTotalMs = performance.now() - startupStart
+    const rssReady = process.memoryUsage.rss()
+
+    const done = workers.map(({ worker }) => waitFor(worker, 'done'))
+    const start = performance.now()
+    for (const { worker } of workers) worker.postMessage({ durationMs })
+    const results = await Promise.all(done)
+    const elapsedMs = performance.now() - start
+
+    const terminateStart = performance.now()
+    await Promise.all(workers.map(({ worker }) => worker.terminate()))
+    const terminateMs = performance.now() - terminateStart
+
+    const latencies = Float64Array.from(
+      results.flatMap(({ latencies }) => latencies),
+    ).sort()
+    const perWorker = results.map(({ latencies }) => latencies.length)
+    const sortedStartup = ready
+      .map(({ startupMs }) => startupMs)
+      .sort((a, b) => a - b)
+    const average = (values) =>
+      values.reduce((a, b) => a + b, 0) / values.length
+
+    return {
+      workers: count,
+      concurrency,
+      requests: latencies.length,
+      failed: results.reduce((total, { failed }) => total + failed, 0),
+      requestsPerSec: latencies.length / (elapsedMs / 1000),
+      requestsPerSecPerWorker: latencies.length / (elapsedMs / 1000) / count,
+      // the slowest and the fastest worker, far apart under contention
+      perWorkerRequests: {
+        min: Math.min(...perWorker),
+        max: Math.max(...perWorker),
+      },
+      latencyMs: {
+        p50: percentile(latencies, 0.5),
+        p90: percentile(latencies, 0.9),
+        p99: percentile(latencies, 0.99),
+        p999: percentile(latencies, 0.999),
+      },
+      startupMs: {
+        total: startupTotalMs,
+        p50: percentile(sortedStartup, 0.5),
+        max: sortedStartup[sortedStartup.length - 1],
+        // require of the library, including the addon and its instance data
+        load: average(ready.map(({ loadMs }) => loadMs)),
+        // creating the Multi handle and the Easy handles
+        setup: average(ready.map(({ setupMs }) => setupMs)),
+      },
+      memory: {
+        rssPerWorker: (rssReady - rssBefore) / count,
+        heapUsedPerWorker: average(ready.map(({ heapUsed }) => heapUsed)),
+      },
+      terminateMs,
+    }
+  }
+
+  const results = []
+
+  try {
+    for (const count of workerCounts) {
+      const result = await runStep(count)
+      results.push(result)
+
+      const rssPerWorker = result.memory.rssPerWorker / 1024 ** 2
+      console.log(
+        `${`${count} workers`.padEnd(12)}` +
+          ` ${result.requestsPerSec.toFixed(0).padStart(8)} req/s` +
+          ` (${result.requestsPerSecPerWorker.toFixed(0)}/worker)` +
+          `  p99 ${result.latencyMs.p99?.toFixed(2)}ms` +
+          `  startup p50 ${result.startupMs.p50.toFixed(1)}ms` +
+          ` max ${result.startupMs.max.toFixed(1)}ms` +
+          `  rss/worker ${rssPerWorker.toFixed(1)} MiB`,
+      )
+    }
+  } finally {
+    servers?.child.disconnect()
+  }
+
+  const report = {
+    date: new Date().toISOString(),
+    libcurl: Curl.getVersion(),
+    node: process.version,
+    platform: `${process.platform} ${process.arch}`,
+    cpus: `${os.cpus().length}x ${os.cpus()[0]?.model ?? 'unknown'}`,
+    memory: os.totalmem(),
+    options: {
+      workers: workerCounts,
+      concurrency,
+      durationMs,
+      protocol: args.protocol,
+      url: args.url,
+    },
+    results,
+  }
+
+  const output =
+    args.output ??
+    path.join(
+      __dirname,
+      `results-workers-${report.date.replace(/[:.]/g, '-')}.json`,
+    )
+  fs.writeFileSync(output, JSON.stringify(report, null, 2))
+
+  console.log(`\nResults written to ${output}`)
+}
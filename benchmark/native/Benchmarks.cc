@@ -0,0 +1,508 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "Arena.h"
+#include "Benchmarks.h"
+#include "Curl.h"
+#include "Easy.h"
+#include "LocaleGuard.h"
+#include "Multi.h"
+
+#include <benchmark/benchmark.h>
+#include <curl/curl.h>
+#include <napi.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace NodeLibcurl::Benchmarks {
+
+class MultiAccess {
+ public:
+  using SocketContext = Multi::CurlSocketContext;
+
+  static SocketContext* Create(curl_socket_t sockfd, Multi* multi) noexcept {
+    return Multi::CreateCurlSocketContext(sockfd, multi);
+  }
+
+  static void Destroy(SocketContext* ctx) { Multi::DestroyCurlSocketContext(ctx); }
+};
+
+class EasyAccess {
+ public:
+  static void SetReadBufferMode(Easy* easy, bool isBorrowed) {
+    easy->readBufferMode =
+        isBorrowed ? Easy::ReadBufferMode::Borrowed : Easy::ReadBufferMode::Pooled;
+    easy->readBufferPool.Reset();
+  }
+
+  static Napi::Buffer<char> GetReadFunctionBuffer(Easy* easy, char* ptr, size_t size,
+                                                  bool* isBorrowed) {
+    return easy->GetReadFunctionBuffer(ptr, size, isBorrowed);
+  }
+
+  static void DetachBorrowedBuffer(Napi::Env env, const Napi::Buffer<char>& buffer) {
+    Easy::DetachBorrowedBuffer(env, buffer);
+  }
+};
+
+namespace {
+
+// What the benchmarks run against, only set while Run is running.
+struct Context {
+  Napi::Env env;
+  Multi* multi;
+  Easy* easy;
+  std::string fileUrl;
+};
+
+Context* context = nullptr;
+
+// How the data received from libcurl is handed to JS, see Easy::OnData.
+enum class CopyStrategy : int64_t {
+  // a new Buffer with a copy of the data, the same call OnData does
+  Copy = 0,
+  // an external Buffer over the memory of libcurl, detached after the callback, from
+  // Easy::GetReadFunctionBuffer with ReadBufferMode::Borrowed
+  Borrowed = 1,
+  // the data copied into the Buffer Easy::GetReadFunctionBuffer reuses with
+  // ReadBufferMode::Pooled
+  Pooled = 2,
+};
+
+const char* CopyStrategyName(CopyStrategy strategy) {
+  switch (strategy) {
+    case CopyStrategy::Copy:
+      return "copy";
+    case CopyStrategy::Borrowed:
+      return "borrowed";
+    case CopyStrategy::Pooled:
+      return "pooled";
+  }
+  return "unknown";
+}
+
+// The Borrowed and Pooled strategies go through the helpers of the READFUNCTION Buffer of the
+// Easy handle given to Run, so they measure the code the addon runs.
+class DataCopier {
+ public:
+  DataCopier(Napi::Env env, Easy* easy, CopyStrategy strategy)
+      : env(env), easy(easy), strategy(strategy) {
+    if (this->strategy != CopyStrategy::Copy) {
+      EasyAccess::SetReadBufferMode(this->easy, this->strategy == CopyStrategy::Borrowed);
+    }
+  }
+
+  // Returns false if the strategy is not available on this runtime.
+  bool Deliver(char* data, size_t length) {
+    Napi::HandleScope scope(this->env);
+
+    switch (this->strategy) {
+      case CopyStrategy::Copy: {
+        auto buffer = Napi::Buffer<char>::Copy(this->env, data, length);
+        benchmark::DoNotOptimize(buffer);
+        return true;
+      }
+
+      case CopyStrategy::Borrowed: {
+        bool isBorrowed = false;
+        auto buffer = EasyAccess::GetReadFunctionBuffer(this->easy, data, length, &isBorrowed);
+
+        // external buffers are not allowed, and it fell back to the pool
+        if (!isBorrowed) return false;
+
+        EasyAccess::DetachBorrowedBuffer(this->env, buffer);
+        return true;
+      }
+
+      case CopyStrategy::Pooled: {
+        bool isBorrowed = false;
+        auto buffer = EasyAccess::GetReadFunctionBuffer(this->easy, data, length, &isBorrowed);
+        std::memcpy(buffer.Data(), data, length);
+        benchmark::DoNotOptimize(buffer);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+ private:
+  Napi::Env env;
+  Easy* easy;
+  CopyStrategy strategy;
+};
+
+// Skips the benchmark if the strategy needs the Easy handle, and none was given to Run.
+bool HasEasyFor(benchmark::State& state, CopyStrategy strategy) {
+  if (strategy != CopyStrategy::Copy && !context->easy) {
+    state.SkipWithError("No Easy handle given");
+    return false;
+  }
+
+  return true;
+}
+
+// The options Easy::SetOpt goes through before reaching the integer ones, in the order of its
+// else if chain, which points back here.
+const std::vector<const std::vector<CurlConstant>*> setOptChain = {
+    &curlOptionNotImplemented, &curlOptionSpecific, &curlOptionLinkedList,
+    &curlOptionString,         &curlOptionInteger,
+};
+
+void BM_ConstantLookupByName(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value name = Napi::String::New(context->env, "url");
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(IsInsideCurlConstantStruct(curlOptionString, name));
+  }
+}
+BENCHMARK(BM_ConstantLookupByName);
+
+void BM_ConstantLookupByValue(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value value = Napi::Number::New(context->env, CURLOPT_URL);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(IsInsideCurlConstantStruct(curlOptionString, value));
+  }
+}
+BENCHMARK(BM_ConstantLookupByValue);
+
+// The lookups done by Easy::SetOpt for an integer option, which misses four times first.
+void BM_SetOptLookupChain(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value name = Napi::String::New(context->env, "FOLLOWLOCATION");
+
+  for (auto _ : state) {
+    int32_t optionId = 0;
+    for (const auto* constants : setOptChain) {
+      if ((optionId = IsInsideCurlConstantStruct(*constants, name))) break;
+    }
+    benchmark::DoNotOptimize(optionId);
+  }
+}
+BENCHMARK(BM_SetOptLookupChain);
+
+void BM_SetOptString(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value opt = Napi::Number::New(context->env, CURLOPT_URL);
+  Napi::Value value = Napi::String::New(context->env, "http://127.0.0.1:8080/some/path?query=1");
+  CURL* ch = curl_easy_init();
+
+  for (auto _ : state) {
+    int32_t optionId = IsInsideCurlConstantStruct(curlOptionString, opt);
+    std::string valueStr = value.As<Napi::String>().Utf8Value();
+    curl_easy_setopt(ch, static_cast<CURLoption>(optionId), valueStr.c_str());
+  }
+
+  curl_easy_cleanup(ch);
+}
+BENCHMARK(BM_SetOptString);
+
+// POSTFIELDS is not copied by libcurl, so the value is copied to the arena of the handle instead.
+void BM_SetOptPostFields(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value value =
+      Napi::String::New(context->env, std::string(static_cast<size_t>(state.range(0)), 'a'));
+  CURL* ch = curl_easy_init();
+  Arena arena;
+
+  for (auto _ : state) {
+    char* postFields = arena.CopyString(value);
+    curl_easy_setopt(ch, CURLOPT_POSTFIELDS, postFields);
+    arena.Reset();
+  }
+
+  curl_easy_cleanup(ch);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetOptPostFields)->Arg(64)->Arg(4 << 10)->Arg(256 << 10);
+
+void BM_SetOptInteger(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  Napi::Value opt = Napi::Number::New(context->env, CURLOPT_TIMEOUT_MS);
+  Napi::Value value = Napi::Number::New(context->env, 5000);
+  CURL* ch = curl_easy_init();
+
+  for (auto _ : state) {
+    int32_t optionId = IsInsideCurlConstantStruct(curlOptionInteger, opt);
+    auto valueNumber = value.ToNumber();
+    curl_easy_setopt(ch, static_cast<CURLoption>(optionId),
+                     static_cast<long>(valueNumber.Int32Value()));  // NOLINT(runtime/int)
+  }
+
+  curl_easy_cleanup(ch);
+}
+BENCHMARK(BM_SetOptInteger);
+
+const std::vector<std::string> headerLines = {
+    "HTTP/1.1 200 OK\r\n",
+    "Date: Mon, 19 Oct 2026 12:00:00 GMT\r\n",
+    "Content-Type: application/json; charset=utf-8\r\n",
+    "Content-Length: 1024\r\n",
+    "Connection: keep-alive\r\n",
+    "Cache-Control: no-cache, no-store, must-revalidate\r\n",
+    "ETag: \"5d8c72a5edda8d6a:0\"\r\n",
+    "Vary: Accept-Encoding\r\n",
+    "Server: node\r\n",
+    "X-Request-Id: 7f3c2b9e-4c1a-4b5e-9d2f-0a1b2c3d4e5f\r\n",
+    "Set-Cookie: session=abcdef0123456789; Path=/; HttpOnly; Secure\r\n",
+    "\r\n",
+};
+
+// Each header line of a response is copied to a Buffer for the HEADERFUNCTION callback.
+void BM_HeaderLines(benchmark::State& state) {
+  auto strategy = static_cast<CopyStrategy>(state.range(0));
+  if (!HasEasyFor(state, strategy)) return;
+
+  DataCopier copier(context->env, context->easy, strategy);
+  std::vector<std::string> lines = headerLines;
+  int64_t bytes = 0;
+
+  for (auto _ : state) {
+    for (auto& line : lines) {
+      if (!copier.Deliver(line.data(), line.size())) {
+        state.SkipWithError("Strategy not supported by this runtime");
+        return;
+      }
+      bytes += static_cast<int64_t>(line.size());
+    }
+  }
+
+  state.SetLabel(CopyStrategyName(strategy));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lines.size()));
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_HeaderLines)->DenseRange(0, 2);
+
+// The header lines given to the HTTPHEADER option, as a HeaderList or Easy::SetOpt builds them.
+void BM_HeaderListArena(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  std::vector<Napi::Value> values;
+  for (const auto& line : headerLines) {
+    values.push_back(Napi::String::New(context->env, line.substr(0, line.size() - 2)));
+  }
+  Arena arena;
+
+  for (auto _ : state) {
+    curl_slist* first = nullptr;
+    curl_slist** next = &first;
+
+    for (const auto& value : values) {
+      *next = arena.NewSlistNode(arena.CopyString(value));
+      next = &(*next)->next;
+    }
+
+    benchmark::DoNotOptimize(first);
+    arena.Reset();
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+BENCHMARK(BM_HeaderListArena);
+
+// The same, with the std::string and curl_slist_append allocations the arena replaced.
+void BM_HeaderListSlistAppend(benchmark::State& state) {
+  Napi::HandleScope scope(context->env);
+  std::vector<Napi::Value> values;
+  for (const auto& line : headerLines) {
+    values.push_back(Napi::String::New(context->env, line.substr(0, line.size() - 2)));
+  }
+
+  for (auto _ : state) {
+    curl_slist* list = nullptr;
+
+    for (const auto& value : values) {
+      std::string header = value.As<Napi::String>().Utf8Value();
+      list = curl_slist_append(list, header.c_str());
+    }
+
+    benchmark::DoNotOptimize(list);
+    curl_slist_free_all(list);
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+BENCHMARK(BM_HeaderListSlistAppend);
+
+void BM_LocaleGuard(benchmark::State& state) {
+  for (auto _ : state) {
+    LocaleGuard guard;
+    benchmark::DoNotOptimize(&guard);
+  }
+}
+BENCHMARK(BM_LocaleGuard);
+
+#ifndef _WIN32
+// The contexts are only freed when the event loop runs the close callbacks, after the benchmarks
+// return, so the iterations are fixed to keep the memory held until then bounded.
+void BM_SocketContext(benchmark::State& state) {
+  if (!context->multi) {
+    state.SkipWithError("No Multi handle given");
+    return;
+  }
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    state.SkipWithError("Could not create the sockets");
+    return;
+  }
+
+  for (auto _ : state) {
+    auto ctx = MultiAccess::Create(fds[0], context->multi);
+    MultiAccess::Destroy(ctx);
+  }
+
+  close(fds[0]);
+  close(fds[1]);
+}
+BENCHMARK(BM_SocketContext)->Iterations(1 << 16);
+#endif
+
+void BM_DataCopy(benchmark::State& state) {
+  auto strategy = static_cast<CopyStrategy>(state.range(0));
+  if (!HasEasyFor(state, strategy)) return;
+
+  DataCopier copier(context->env, context->easy, strategy);
+  std::vector<char> chunk(static_cast<size_t>(state.range(1)), 'a');
+
+  for (auto _ : state) {
+    if (!copier.Deliver(chunk.data(), chunk.size())) {
+      state.SkipWithError("Strategy not supported by this runtime");
+      return;
+    }
+  }
+
+  state.SetLabel(CopyStrategyName(strategy));
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_DataCopy)
+    ->ArgNames({"strategy", "size"})
+    ->ArgsProduct({{0, 1, 2}, {1 << 10, 16 << 10, 512 << 10}});
+
+struct TransferState {
+  DataCopier* copier;
+  bool failed;
+};
+
+size_t TransferWriteFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
+  auto transfer = static_cast<TransferState*>(userdata);
+
+  if (!transfer->copier->Deliver(ptr, size * nmemb)) {
+    transfer->failed = true;
+    return 0;
+  }
+
+  return size * nmemb;
+}
+
+// A whole transfer of the file given to Run, with file://, delivering the data to JS like
+// OnData would, in chunks of the given BUFFERSIZE.
+void BM_FileTransfer(benchmark::State& state) {
+  if (context->fileUrl.empty()) {
+    state.SkipWithError("No file given");
+    return;
+  }
+
+  auto strategy = static_cast<CopyStrategy>(state.range(0));
+  if (!HasEasyFor(state, strategy)) return;
+
+  DataCopier copier(context->env, context->easy, strategy);
+  TransferState transfer = {&copier, false};
+
+  CURL* ch = curl_easy_init();
+  curl_easy_setopt(ch, CURLOPT_URL, context->fileUrl.c_str());
+  curl_easy_setopt(ch, CURLOPT_BUFFERSIZE, static_cast<long>(state.range(1)));  // NOLINT
+  curl_easy_setopt(ch, CURLOPT_WRITEFUNCTION, TransferWriteFunction);
+  curl_easy_setopt(ch, CURLOPT_WRITEDATA, &transfer);
+
+  int64_t bytes = 0;
+
+  for (auto _ : state) {
+    CURLcode code = curl_easy_perform(ch);
+
+    if (code != CURLE_OK) {
+      state.SkipWithError(transfer.failed ? "Strategy not supported by this runtime"
+                                          : curl_easy_strerror(code));
+      break;
+    }
+
+    curl_off_t downloaded = 0;
+    curl_easy_getinfo(ch, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    bytes += downloaded;
+  }
+
+  curl_easy_cleanup(ch);
+
+  state.SetLabel(CopyStrategyName(strategy));
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_FileTransfer)
+    ->ArgNames({"strategy", "bufferSize"})
+    ->ArgsProduct({{0, 1, 2}, {16 << 10, 512 << 10}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+Napi::Value Run(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    throw Napi::TypeError::New(env, "Arguments must be an array of strings.");
+  }
+
+  Napi::Array args = info[0].As<Napi::Array>();
+  std::vector<std::string> argStorage = {"node-libcurl-benchmarks"};
+  for (uint32_t i = 0; i < args.Length(); i++) {
+    argStorage.push_back(args.Get(i).ToString().Utf8Value());
+  }
+
+  std::vector<char*> argv;
+  for (auto& arg : argStorage) argv.push_back(arg.data());
+  int argc = static_cast<int>(argv.size());
+
+  Context ctx = {env, nullptr, nullptr, ""};
+
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    Napi::Value multi = options.Get("multi");
+    if (multi.IsObject()) {
+      ctx.multi = Napi::ObjectWrap<Multi>::Unwrap(multi.As<Napi::Object>());
+    }
+
+    Napi::Value easy = options.Get("easy");
+    if (easy.IsObject()) {
+      ctx.easy = Napi::ObjectWrap<Easy>::Unwrap(easy.As<Napi::Object>());
+    }
+
+    Napi::Value file = options.Get("file");
+    if (file.IsString()) {
+      ctx.fileUrl = "file://" + file.As<Napi::String>().Utf8Value();
+    }
+  }
+
+  benchmark::Initialize(&argc, argv.data());
+  if (benchmark::ReportUnrecognizedArguments(argc, argv.data())) {
+    throw Napi::Error::New(env, "Unrecognized benchmark arguments.");
+  }
+
+  context = &ctx;
+  benchmark::RunSpecifiedBenchmarks();
+  context = nullptr;
+
+  return env.Undefined();
+}
+
+}  // namespace NodeLibcurl::Benchmarks
@@ -0,0 +1,40 @@
+import crypto from 'crypto'
+import fs from 'fs'
+import os from 'os'
+import path from 'path'
+
+import { createRequire } from 'module'
+const require = createRequire(import.meta.url)
+const binding = require('../../lib/binding/node_libcurl.node')
+
+if (typeof binding.Curl.runBenchmarks !== 'function') {
+  console.error(
+    'The addon was built without the native benchmarks, rebuild it with:\n' +
+      '  pnpm pregyp rebuild --node_libcurl_benchmarks=true',
+  )
+  process.exit(1)
+}
+
+console.log(binding.Curl.getVersion())
+
+// transferred with file:// by the BM_FileTransfer benchmarks
+const FILE_SIZE = parseInt(process.env.FILE_SIZE || `${8 * 1024 * 1024}`, 10)
+const file = path.join(
+  os.tmpdir(),
+  `node-libcurl-native-benchmark-${process.pid}.bin`,
+)
+fs.writeFileSync(file, crypto.randomBytes(FILE_SIZE))
+
+const multi = new binding.Multi()
+// its READFUNCTION Buffer helpers are used by the borrowed and pooled strategies
+const easy = new binding.Easy()
+
+try {
+  // every argument is forwarded to Google Benchmark, like --benchmark_filter=BM_DataCopy
+  binding.Curl.runBenchmarks(process.argv.slice(2), { multi, easy, file })
+} finally {
+  easy.close()
+  // the socket contexts are closed by the event loop, after the benchmarks return
+  setImmediate(() => multi.close())
+  fs.rmSync(file, { force: true })
+}
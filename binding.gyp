@@ -12,6 +12,14 @@
     'curl_config_bin%': 'node <(module_root_dir)/scripts/curl-config.js',
     'node_libcurl_no_setlocale%': 'false',
     'node_libcurl_debug%': 'false',
+    # USDT probes, see src/Probes.h, Linux only, requires sys/sdt.h
+    'node_libcurl_usdt%': 'false',
+    # Allocator used by libcurl, see src/Allocator.h: system, mimalloc or jemalloc
+    'node_libcurl_allocator%': 'system',
+    # Linker flags of the allocator, in case the default ones are not enough
+    'node_libcurl_allocator_libraries%': '',
+    # Native microbenchmarks, see benchmark/native, requires Google Benchmark
+    'node_libcurl_benchmarks%': 'false',
     'node_libcurl_asan_debug%': 'false',
     'node_libcurl_cpp_std%': 'c++20',
     'macos_universal_build%': 'false'
@@ -27,6 +35,7 @@
       ],
       'sources': [
         'src/node_libcurl.cc',
+        'src/Arena.cc',
         'src/Easy.cc',
         'src/Share.cc',
         'src/Multi.cc',
@@ -36,6 +45,12 @@
         'src/CurlError.cc',
         'src/CurlVersionInfo.cc',
         'src/Http2PushFrameHeaders.cc',
+        'src/HeaderList.cc',
+        'src/UploadSource.cc',
+        'src/DebugLog.cc',
+        'src/Trace.cc',
+        'src/MemoryTracker.cc',
+        'src/Allocator.cc',
       ],
       'include_dirs': [
         '<!@(node -p "require(\'node-addon-api\').include")',
@@ -55,6 +70,46 @@
             'NODE_LIBCURL_DEBUG'
           ]
         }],
+        ['node_libcurl_usdt=="true" and OS=="linux"', {
+          'defines': [
+            'NODE_LIBCURL_USDT'
+          ]
+        }],
+        ['node_libcurl_allocator=="mimalloc"', {
+          'defines': [
+            'NODE_LIBCURL_ALLOCATOR_MIMALLOC'
+          ],
+          'conditions': [
+            ['node_libcurl_allocator_libraries==""', {
+              'libraries': ['-lmimalloc']
+            }]
+          ]
+        }],
+        ['node_libcurl_allocator=="jemalloc"', {
+          'defines': [
+            'NODE_LIBCURL_ALLOCATOR_JEMALLOC'
+          ],
+          'conditions': [
+            ['node_libcurl_allocator_libraries==""', {
+              'libraries': ['-ljemalloc']
+            }]
+          ]
+        }],
+        ['node_libcurl_benchmarks=="true"', {
+          'sources': [
+            'benchmark/native/Benchmarks.cc',
+          ],
+          'include_dirs': [
+            'src',
+          ],
+          'defines': [
+            'NODE_LIBCURL_BENCHMARKS'
+          ],
+          'libraries': ['-lbenchmark', '-lpthread']
+        }],
+        ['node_libcurl_allocator_libraries!=""', {
+          'libraries': ['<@(node_libcurl_allocator_libraries)']
+        }],
         ['curl_include_dirs!=""', {
           'include_dirs': ['<@(curl_include_dirs)']
         }],
@@ -0,0 +1,323 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import type { Curl, TraceRecord } from './Curl'
+import { CurlCode } from './enum/CurlCode'
+import { TraceCallback, TraceEvent, TraceTransferTime } from './enum/TraceEvent'
+
+/**
+ * An event of the [Trace Event Format](https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU),
+ *  as created by {@link toChromeTrace | `toChromeTrace`}.
+ *
+ * @public
+ */
+export interface ChromeTraceEvent {
+  name: string
+  cat?: string
+  ph: 'X' | 'B' | 'i' | 'M'
+  /**
+   * Microseconds.
+   */
+  ts: number
+  /**
+   * Microseconds, only for complete (`X`) events.
+   */
+  dur?: number
+  pid: number
+  tid: number
+  s?: 't' | 'p' | 'g'
+  args?: Record<string, unknown>
+}
+
+/**
+ * Returned by {@link toChromeTrace | `toChromeTrace`}, `JSON.stringify` it to a file.
+ *
+ * @public
+ */
+export interface ChromeTrace {
+  traceEvents: ChromeTraceEvent[]
+  displayTimeUnit: 'ms' | 'ns'
+}
+
+/**
+ * Options of {@link toChromeTrace | `toChromeTrace`}.
+ *
+ * @public
+ */
+export interface ChromeTraceOptions {
+  /**
+   * Defaults to `process.pid`.
+   */
+  pid?: number
+}
+
+// track of the events of the Multi handles themselves, each Easy handle gets its own track
+const loopTid = 0
+
+// the parts of a transfer, between two of the times reported by libcurl
+const transferParts: [string, TraceTransferTime, TraceTransferTime][] = [
+  ['queued', TraceTransferTime.Queue, TraceTransferTime.Queue],
+  ['dns', TraceTransferTime.Queue, TraceTransferTime.NameLookup],
+  ['connect', TraceTransferTime.NameLookup, TraceTransferTime.Connect],
+  ['tls', TraceTransferTime.Connect, TraceTransferTime.AppConnect],
+  ['request', TraceTransferTime.AppConnect, TraceTransferTime.PreTransfer],
+  [
+    'first byte',
+    TraceTransferTime.PreTransfer,
+    TraceTransferTime.StartTransfer,
+  ],
+  ['receive', TraceTransferTime.StartTransfer, TraceTransferTime.Total],
+]
+
+const instantEvents: Partial<Record<TraceEvent, string>> = {
+  [TraceEvent.MultiAddHandle]: 'added to multi',
+  [TraceEvent.MultiRemoveHandle]: 'removed from multi',
+  [TraceEvent.MultiCancelHandle]: 'cancelled',
+  [TraceEvent.MultiTransferDone]: 'done',
+}
+
+const loopSpans: Partial<Record<TraceEvent, string>> = {
+  [TraceEvent.MultiOnSocket]: 'socket ready',
+  [TraceEvent.MultiOnTimeout]: 'timeout',
+  [TraceEvent.MultiProcessMessages]: 'process messages',
+}
+
+/**
+ * Converts the records returned by {@link Curl.drainTrace | `Curl.drainTrace`}
+ *  to the Trace Event Format, which can be opened with `chrome://tracing`
+ *  or with [Perfetto](https://ui.perfetto.dev).
+ *
+ * Each Easy handle gets its own track, with a span for each of its transfers, the parts of
+ *  the transfer reported by libcurl (queued, dns, connect, tls, request, first byte and receive),
+ *  and a span for each call of a JavaScript callback.
+ * The work done by the Multi handles on the event loop, and how long it took, is on a separate track.
+ *
+ * @public
+ */
+export function toChromeTrace(
+  records: TraceRecord[],
+  options: ChromeTraceOptions = {},
+): ChromeTrace {
+  const pid = options.pid ?? process.pid
+  const traceEvents: ChromeTraceEvent[] = []
+
+  if (!records.length) {
+    return { traceEvents, displayTimeUnit: 'ms' }
+  }
+
+  // timestamps are relative to the first record, as the absolute ones are too large
+  //  to keep nanosecond precision once converted to microseconds
+  const origin = records.reduce(
+    (min, record) => (record.timestamp < min ? record.timestamp : min),
+    records[0].timestamp,
+  )
+  const toUs = (timestamp: bigint) => Number(timestamp - origin) / 1000
+
+  const handles = new Set<number>()
+  // start of the transfer running on each handle
+  const transferStarts = new Map<number, TraceRecord>()
+  // times reported by libcurl, per handle, until all of them arrive
+  const transferTimes = new Map<number, Map<TraceTransferTime, number>>()
+
+  const addTransferParts = (
+    record: TraceRecord,
+    times: Map<number, number>,
+  ) => {
+    const start = toUs(record.timestamp)
+
+    for (const [name, from, to] of transferParts) {
+      const toTime = times.get(to)
+      // not reported by this version of libcurl, or did not happen (tls for plain connections)
+      if (!toTime) continue
+
+      const fromTime = from === to ? 0 : getLatestTime(times, from)
+      if (toTime <= fromTime) continue
+
+      traceEvents.push({
+        name,
+        cat: 'transfer',
+        ph: 'X',
+        ts: start + fromTime / 1000,
+        dur: (toTime - fromTime) / 1000,
+        pid,
+        tid: record.handleId,
+      })
+    }
+  }
+
+  for (const record of records) {
+    if (record.handleId) handles.add(record.handleId)
+
+    switch (record.event) {
+      case TraceEvent.EasyTransferStart:
+        transferStarts.set(record.handleId, record)
+        break
+
+      case TraceEvent.EasyTransferEnd: {
+        const start = transferStarts.get(record.handleId)
+        transferStarts.delete(record.handleId)
+
+        const ts = start ? toUs(start.timestamp) : 0
+        traceEvents.push({
+          name: 'transfer',
+          cat: 'transfer',
+          ph: 'X',
+          ts,
+          dur: toUs(record.timestamp) - ts,
+          pid,
+          tid: record.handleId,
+          args: { code: CurlCode[record.value] ?? record.value },
+        })
+        break
+      }
+
+      case TraceEvent.EasyTransferTime: {
+        let times = transferTimes.get(record.handleId)
+        if (!times) {
+          times = new Map()
+          transferTimes.set(record.handleId, times)
+        }
+
+        times.set(record.value, record.duration)
+
+        // the last one recorded
+        if (record.value === TraceTransferTime.Total) {
+          addTransferParts(record, times)
+          transferTimes.delete(record.handleId)
+        }
+        break
+      }
+
+      case TraceEvent.EasyCallback:
+        traceEvents.push({
+          name: TraceCallback[record.value] ?? `callback ${record.value}`,
+          cat: 'callback',
+          ph: 'X',
+          ts: toUs(record.timestamp),
+          dur: record.duration / 1000,
+          pid,
+          tid: record.handleId,
+        })
+        break
+
+      case TraceEvent.EasyPerform:
+        traceEvents.push({
+          name: 'perform',
+          cat: 'transfer',
+          ph: 'X',
+          ts: toUs(record.timestamp),
+          dur: record.duration / 1000,
+          pid,
+          tid: record.handleId,
+          args: { code: CurlCode[record.value] ?? record.value },
+        })
+        break
+
+      case TraceEvent.MultiSocketAction:
+      case TraceEvent.MultiTimerSet:
+        traceEvents.push({
+          name:
+            record.event === TraceEvent.MultiSocketAction
+              ? 'socket action'
+              : 'timer set',
+          cat: 'multi',
+          ph: 'i',
+          s: 't',
+          ts: toUs(record.timestamp),
+          pid,
+          tid: loopTid,
+          args: {
+            multiId: record.multiId,
+            handleId: record.handleId,
+            socket: record.socket,
+            value: record.value,
+          },
+        })
+        break
+
+      default: {
+        const instantName = instantEvents[record.event]
+        if (instantName) {
+          traceEvents.push({
+            name: instantName,
+            cat: 'multi',
+            ph: 'i',
+            s: 't',
+            ts: toUs(record.timestamp),
+            pid,
+            tid: record.handleId,
+            args: { multiId: record.multiId, value: record.value },
+          })
+          break
+        }
+
+        const spanName = loopSpans[record.event]
+        if (spanName) {
+          traceEvents.push({
+            name: spanName,
+            cat: 'multi',
+            ph: 'X',
+            ts: toUs(record.timestamp),
+            dur: record.duration / 1000,
+            pid,
+            tid: loopTid,
+            args: {
+              multiId: record.multiId,
+              socket: record.socket,
+              value: record.value,
+            },
+          })
+        }
+      }
+    }
+  }
+
+  // transfers still running when the records were drained
+  for (const [handleId, start] of transferStarts) {
+    traceEvents.push({
+      name: 'transfer',
+      cat: 'transfer',
+      ph: 'B',
+      ts: toUs(start.timestamp),
+      pid,
+      tid: handleId,
+    })
+  }
+
+  traceEvents.push(
+    {
+      name: 'thread_name',
+      ph: 'M',
+      ts: 0,
+      pid,
+      tid: loopTid,
+      args: { name: 'Multi' },
+    },
+    ...[...handles].map(
+      (handleId): ChromeTraceEvent => ({
+        name: 'thread_name',
+        ph: 'M',
+        ts: 0,
+        pid,
+        tid: handleId,
+        args: { name: `Easy #${handleId}` },
+      }),
+    ),
+  )
+
+  return { traceEvents, displayTimeUnit: 'ms' }
+}
+
+// the latest time reported up to the given one, as the times that did not happen are 0
+function getLatestTime(times: Map<number, number>, upTo: TraceTransferTime) {
+  let latest = 0
+
+  for (let time = TraceTransferTime.Queue; time <= upTo; time++) {
+    latest = Math.max(latest, times.get(time) ?? 0)
+  }
+
+  return latest
+}
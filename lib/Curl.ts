@@ -7,6 +7,7 @@
 import './moduleSetup'
 
 import { EventEmitter } from 'events'
+import os from 'os'
 import { StringDecoder } from 'string_decoder'
 import { Readable } from 'stream'
 
@@ -18,6 +19,7 @@ import { Easy } from './Easy'
 import { Multi } from './Multi'
 import { Share } from './Share'
 import { CurlMime } from './CurlMime'
+import { HeaderList } from './HeaderList'
 import { mergeChunks } from './mergeChunks'
 import { parseHeaders, HeaderInfo } from './parseHeaders'
 import {
@@ -64,7 +66,14 @@ import { CurlUseSsl } from './enum/CurlUseSsl'
 import { CurlWriteFunc } from './enum/CurlWriteFunc'
 import { CurlReadFunc } from './enum/CurlReadFunc'
 import { CurlWsOptions } from './enum/CurlWs'
-import { CurlInfoNameSpecific, GetInfoReturn } from './Easy'
+import { ReadBufferMode } from './enum/ReadBufferMode'
+import { TraceEvent } from './enum/TraceEvent'
+import {
+  CurlInfoNameSpecific,
+  DebugLogOptions,
+  GetInfoReturn,
+  ProgressThrottleOptions,
+} from './Easy'
 import { CurlyMimePart } from './CurlyMimeTypes'
 
 const bindings: typeof NodeLibcurlNativeBinding = require('../lib/binding/node_libcurl.node')
@@ -72,9 +81,108 @@ const bindings: typeof NodeLibcurlNativeBinding = require('../lib/binding/node_l
 const { Curl: _Curl, CurlVersionInfo } = bindings
 
 const decoder = new StringDecoder('utf8')
+// keep in sync with Trace::Record on src/Trace.h
+const traceRecordSize = 48
+const isLittleEndian = os.endianness() === 'LE'
 // Handle used by curl instances created by the Curl wrapper.
 const multiHandle = new Multi()
 
+/**
+ * A record of the internal trace, see {@link Curl.setTraceEnabled | `Curl.setTraceEnabled`}.
+ *
+ * @public
+ */
+export interface TraceRecord {
+  event: TraceEvent
+  /**
+   * `process.hrtime.bigint()` compatible timestamp of when the event started.
+   */
+  timestamp: bigint
+  /**
+   * Time spent on the event, in nanoseconds, `0` for events that are not a span.
+   */
+  duration: number
+  /**
+   * Id of the {@link Multi | `Multi`} handle, `0` if the event is not from one.
+   */
+  multiId: number
+  /**
+   * Id of the {@link Easy | `Easy`} handle, `0` if the event is not from a specific one.
+   */
+  handleId: number
+  /**
+   * The socket of the event, `-1` if the event is not from a specific one.
+   */
+  socket: number
+  /**
+   * Depends on the event, see {@link TraceEvent | `TraceEvent`}.
+   */
+  value: number
+}
+
+/**
+ * Returned by {@link Curl.drainTrace | `Curl.drainTrace`}.
+ *
+ * @public
+ */
+export interface TraceSnapshot {
+  /**
+   * Records overwritten before they were drained, because the buffer was full.
+   */
+  dropped: number
+  /**
+   * From oldest to newest.
+   */
+  records: TraceRecord[]
+}
+
+/**
+ * Returned by {@link Curl.getMemoryUsage | `Curl.getMemoryUsage`}.
+ *
+ * @public
+ */
+export interface MemoryUsage {
+  /**
+   * Whether the memory allocated by libcurl is being tracked,
+   *  which requires the `NODE_LIBCURL_TRACK_MEMORY` environment variable
+   *  to be set before the addon is loaded. All the other values are `0` otherwise.
+   */
+  tracked: boolean
+  /**
+   * The allocator used by libcurl, `system` unless the addon was built with
+   *  the `node_libcurl_allocator` variable set.
+   */
+  allocator: 'system' | 'mimalloc' | 'jemalloc'
+  /**
+   * Bytes currently allocated by libcurl from the current thread.
+   */
+  total: number
+  /**
+   * Bytes currently reported to V8 as external memory, for the current thread.
+   *
+   * This is updated whenever the tracked memory changes by at least 64 KiB.
+   */
+  reported: number
+  /**
+   * The `total` by what the addon was doing when the memory was allocated.
+   */
+  categories: {
+    /**
+     * Creating, duplicating, resetting and closing handles.
+     */
+    handles: number
+    /**
+     * Setting options.
+     */
+    options: number
+    /**
+     * Running transfers, this includes the connection cache, TLS contexts and buffers.
+     */
+    transfers: number
+    other: number
+  }
+}
+
 /**
  * Wrapper around {@link Easy | `Easy`} class with a more *nodejs-friendly* interface.
  *
@@ -365,6 +473,10 @@ class Curl extends EventEmitter {
 
     this.features |= bitmask
 
+    if (bitmask & CurlFeature.ZeroCopyBuffers) {
+      this.handle.setZeroCopy(true)
+    }
+
     return this
   }
 
@@ -382,6 +494,10 @@ class Curl extends EventEmitter {
 
     this.features &= ~bitmask
 
+    if (bitmask & CurlFeature.ZeroCopyBuffers) {
+      this.handle.setZeroCopy(false)
+    }
+
     return this
   }
 
@@ -503,6 +619,7 @@ class Curl extends EventEmitter {
         this.cleanupReadFunctionStreamEvents()
         this.readFunctionStream = null
         this.setOpt('READFUNCTION', null)
+        this.handle.setReadBufferMode(ReadBufferMode.Copy)
       }
       return this
     }
@@ -580,6 +697,8 @@ class Curl extends EventEmitter {
           'Curl upload stream was unexpectedly destroyed',
         )
 
+        if (this.cancelStreamTransfer()) return
+
         this.streamReadFunctionShouldPause = true
         resumeIfPaused()
       }
@@ -587,6 +706,8 @@ class Curl extends EventEmitter {
     attachEventListenerToStream('error', (error: Error) => {
       this.streamError = error
 
+      if (this.cancelStreamTransfer()) return
+
       this.streamReadFunctionShouldPause = true
       resumeIfPaused()
     })
@@ -625,6 +746,10 @@ class Curl extends EventEmitter {
       return totalWritten
     })
 
+    // the buffer is only used inside the callback above,
+    // so it can be libcurl's own upload buffer, instead of a new one for every chunk.
+    this.handle.setReadBufferMode(ReadBufferMode.Borrowed)
+
     return this
   }
 
@@ -671,6 +796,71 @@ class Curl extends EventEmitter {
     return this
   }
 
+  /**
+   * Limits how often the progress callback is called, natively,
+   *  see {@link Easy.setProgressThrottle | `Easy#setProgressThrottle`}.
+   *
+   * This also applies to the internal progress callback used by the stream features,
+   *  and so to the one set with {@link setStreamProgressCallback | `setStreamProgressCallback`}.
+   * Pausing the response stream when it is not being read fast enough waits for the next tick
+   *  reaching the throttle, so keep its thresholds small when using streams.
+   */
+  setProgressThrottle(options: ProgressThrottleOptions | null) {
+    this.handle.setProgressThrottle(options)
+
+    return this
+  }
+
+  /**
+   * Publishes the progress of the transfers of this instance to `array`, natively,
+   *  see {@link Easy.setProgressCounters | `Easy#setProgressCounters`}.
+   */
+  setProgressCounters(array: Float64Array | BigInt64Array | null) {
+    this.handle.setProgressCounters(array)
+
+    return this
+  }
+
+  /**
+   * Records the debug output of libcurl natively,
+   *  see {@link Easy.setDebugLog | `Easy#setDebugLog`}.
+   */
+  setDebugLog(options: DebugLogOptions | null) {
+    this.handle.setDebugLog(options)
+
+    return this
+  }
+
+  /**
+   * Returns the entries recorded by the debug log since the last call,
+   *  see {@link Easy.drainDebugLog | `Easy#drainDebugLog`}.
+   */
+  drainDebugLog() {
+    return this.handle.drainDebugLog()
+  }
+
+  /**
+   * Cancels the request being performed, natively, so it stops on the next callback libcurl calls,
+   *  see {@link Easy.cancel | `Easy#cancel`}.
+   *
+   * The `error` event is emitted with `CURLE_ABORTED_BY_CALLBACK`, and `reason` as its `cause`.
+   */
+  cancel(reason?: Error) {
+    this.handle.cancel(reason)
+
+    return this
+  }
+
+  /**
+   * Cancels the request once `signal` is aborted,
+   *  see {@link Easy.setAbortSignal | `Easy#setAbortSignal`}.
+   */
+  setAbortSignal(signal: AbortSignal | null) {
+    this.handle.setAbortSignal(signal)
+
+    return this
+  }
+
   /**
    * The option `XFERINFOFUNCTION` was introduced in curl version `7.32.0`,
    *  versions older than that should use `PROGRESSFUNCTION`.
@@ -760,6 +950,9 @@ class Curl extends EventEmitter {
     // See: https://github.com/JCMais/node-libcurl/issues/439
     const finalize = (cb: () => void) => {
       setImmediate(() => {
+        // closed while running, which also removed all the listeners
+        if (!this.handle.isOpen) return
+
         try {
           if (this.handle.isOpen && this.handle.isInsideMultiHandle) {
             multi.removeHandle(this.handle)
@@ -907,7 +1100,8 @@ class Curl extends EventEmitter {
     this.removeAllListeners()
 
     if (this.handle.isInsideMultiHandle) {
-      multiHandle.removeHandle(this.handle)
+      const multi = this.multiInstance || multiHandle
+      multi.removeHandle(this.handle)
     }
 
     this.handle.setOpt(Curl.option.WRITEFUNCTION, null)
@@ -936,6 +1130,7 @@ class Curl extends EventEmitter {
     // reset back the READFUNCTION if there was a stream we were reading from
     if (this.readFunctionStream) {
       this.setOpt('READFUNCTION', null)
+      this.handle.setReadBufferMode(ReadBufferMode.Copy)
     }
 
     // these are mostly streams related, as these options are not persisted between requests
@@ -986,6 +1181,21 @@ class Curl extends EventEmitter {
       : headersRaw
   }
 
+  /**
+   * Cancels the running request natively with {@link streamError | `streamError`},
+   *  instead of waiting for the next call of {@link streamModeProgressFunction | `streamModeProgressFunction`}.
+   *
+   * Returns `false` if the request is not inside a `Multi` handle anymore.
+   */
+  protected cancelStreamTransfer() {
+    if (!this.isRunning || !this.streamError) return false
+    if (!this.handle.isOpen || !this.handle.isInsideMultiHandle) return false
+
+    this.handle.cancel(this.streamError)
+
+    return true
+  }
+
   /**
    * The internal function passed to `PROGRESSFUNCTION` (`XFERINFOFUNCTION` on most recent libcurl versions)
    * when using any of the stream features.
@@ -1061,6 +1271,11 @@ class Curl extends EventEmitter {
             error ||
             new Error('Curl response stream was unexpectedly destroyed')
 
+          if (handle.cancelStreamTransfer()) {
+            cb(null)
+            return
+          }
+
           // if the handle is not running anymore it means that the
           // error we set above was caught, if it is still running, then it means that:
           // - the handle is paused
@@ -1150,6 +1365,71 @@ class Curl extends EventEmitter {
     return size * nmemb
   }
 
+  /**
+   * Enables or disables the internal trace of the addon, for all threads.
+   *
+   * While enabled, what the {@link Multi | `Multi`} handles do with their sockets and timers,
+   *  and how long each step takes, is recorded into a fixed size buffer of each thread,
+   *  which can be read with {@link drainTrace | `Curl.drainTrace`}.
+   * It is meant to diagnose event loop stalls, and can be kept enabled in production,
+   *  as nothing is allocated or formatted while recording, and while disabled it costs next to nothing.
+   *
+   * Once a buffer is full, the oldest records are overwritten.
+   *
+   * @param capacity Number of records kept by each thread, defaults to `8192`, 48 bytes each.
+   *  Changing it discards the records not drained yet.
+   */
+  static setTraceEnabled = (enabled: boolean, capacity?: number): void => {
+    _Curl.setTraceEnabled(enabled, capacity)
+  }
+
+  /**
+   * Whether the internal trace is enabled, see {@link setTraceEnabled | `Curl.setTraceEnabled`}.
+   */
+  static isTraceEnabled = (): boolean => _Curl.isTraceEnabled()
+
+  /**
+   * Returns the records of the internal trace since the last call, and empties the buffer.
+   *
+   * Only the records of the current thread are returned,
+   *  each worker thread must drain its own.
+   */
+  static drainTrace = (): TraceSnapshot => {
+    const { dropped, records: buffer } = _Curl.drainTrace()
+    const view = new DataView(buffer)
+    const records: TraceRecord[] = []
+
+    for (
+      let offset = 0;
+      offset < buffer.byteLength;
+      offset += traceRecordSize
+    ) {
+      records.push({
+        timestamp: view.getBigUint64(offset, isLittleEndian),
+        duration: Number(view.getBigUint64(offset + 8, isLittleEndian)),
+        multiId: Number(view.getBigUint64(offset + 16, isLittleEndian)),
+        handleId: Number(view.getBigUint64(offset + 24, isLittleEndian)),
+        socket: Number(view.getBigInt64(offset + 32, isLittleEndian)),
+        value: view.getInt32(offset + 40, isLittleEndian),
+        event: view.getUint16(offset + 44, isLittleEndian),
+      })
+    }
+
+    return { dropped, records }
+  }
+
+  /**
+   * Returns how much memory libcurl is holding for the current thread (the main one, or a worker).
+   *
+   * By default the addon reports to V8 a fixed estimate of the memory used by each handle,
+   *  which does not include connections, TLS contexts or buffered data.
+   * If the `NODE_LIBCURL_TRACK_MEMORY` environment variable is set to `1` before the addon is
+   *  loaded for the first time in the process, every allocation done by libcurl is counted instead,
+   *  and that is what is reported to V8, so the garbage collector can react to the real usage.
+   * Tracking adds 16 bytes to each allocation done by libcurl, and some atomic operations.
+   */
+  static getMemoryUsage = (): MemoryUsage => _Curl.getMemoryUsage()
+
   /**
    * Returns an object with a representation of the current libcurl version and their features/protocols.
    *
@@ -1314,7 +1594,10 @@ interface Curl {
    *
    * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
-  setOpt(option: StringListOptions, value: string[] | null): this
+  setOpt(
+    option: StringListOptions,
+    value: string[] | HeaderList | [...string[], HeaderList] | null,
+  ): this
   /**
    * Use {@link Curl.option|`Curl.option`} for predefined constants.
    *
@@ -1491,6 +1774,16 @@ interface Curl {
    * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
   setOpt(option: 'STREAM_DEPENDS_E', value: Easy | null): this
+  /**
+   * Use {@link Curl.option|`Curl.option`} for predefined constants.
+   *
+   *
+   * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(
+    option: 'POSTFIELDS',
+    value: string | ArrayBuffer | ArrayBufferView | null,
+  ): this
   /**
    * Use {@link Curl.option|`Curl.option`} for predefined constants.
    *
@@ -0,0 +1,286 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import './moduleSetup'
+
+import fs from 'fs'
+
+import {
+  RangeDownloader,
+  RangeDownloaderOptions,
+  RangeDownloadChangedError,
+  RangeDownloadProbe,
+  RangeDownloadResult,
+  RangeDownloadSegment,
+} from './RangeDownloader'
+
+/**
+ * Contents of the checkpoint file kept by {@link DownloadManager | `DownloadManager`}
+ *  while a download is in progress.
+ *
+ * @public
+ */
+export interface DownloadCheckpoint extends RangeDownloadProbe {
+  version: 1
+  /**
+   * URL originally requested, before following redirects.
+   */
+  requestedUrl: string
+  segments: RangeDownloadSegment[]
+}
+
+/**
+ * @public
+ */
+export interface DownloadManagerOptions extends RangeDownloaderOptions {
+  /**
+   * How often the checkpoint is saved while downloading, in milliseconds.
+   * It is also saved when the download fails.
+   *
+   * @defaultValue 1000
+   */
+  checkpointInterval?: number
+
+  /**
+   * Returns the path of the checkpoint file for the given destination.
+   *
+   * @defaultValue `${destination}.checkpoint.json`
+   */
+  getCheckpointPath?: (destination: string) => string
+}
+
+/**
+ * `DownloadManager` is a {@link RangeDownloader | `RangeDownloader`} that can resume downloads
+ *  after the process restarts.
+ *
+ * While downloading, it keeps a checkpoint file next to the destination, with the validators
+ *  of the remote file (`ETag` or `Last-Modified`) and how many bytes of each segment
+ *  were already written. When a download is started again for the same URL and destination,
+ *  only the missing bytes of each segment are requested, with an `If-Range` header,
+ *  so if the remote file changed in the meantime it is downloaded again from scratch.
+ *
+ * The checkpoint is removed once the download finishes.
+ *
+ * @example
+ * ```typescript
+ * import { DownloadManager } from 'node-libcurl'
+ *
+ * const manager = new DownloadManager({ connections: 8 })
+ *
+ * try {
+ *   // if this was interrupted before, it continues from where it stopped
+ *   await manager.download('https://example.com/bundle.tar', './bundle.tar')
+ * } finally {
+ *   manager.close()
+ * }
+ * ```
+ *
+ * @public
+ */
+export class DownloadManager extends RangeDownloader {
+  protected override readonly options: DownloadManagerOptions &
+    Required<
+      Pick<
+        DownloadManagerOptions,
+        'connections' | 'minSegmentSize' | 'checkpointInterval'
+      >
+    >
+
+  constructor(options: DownloadManagerOptions = {}) {
+    super(options)
+
+    this.options = {
+      connections: 8,
+      minSegmentSize: 1024 * 1024,
+      checkpointInterval: 1000,
+      ...options,
+    }
+  }
+
+  /**
+   * Downloads the file at `url` to `destination`, resuming a previous download
+   *  of the same file if there is a checkpoint for it.
+   */
+  override async download(
+    url: string,
+    destination: string,
+  ): Promise<RangeDownloadResult> {
+    const checkpointPath = this.getCheckpointPath(destination)
+    const checkpoint = await this.readCheckpoint(checkpointPath, url)
+
+    if (checkpoint) {
+      try {
+        return await this.resume(checkpoint, destination, checkpointPath)
+      } catch (error) {
+        if (!(error instanceof RangeDownloadChangedError)) throw error
+        // the remote file changed, the bytes we have are useless
+      }
+    }
+
+    await fs.promises.rm(checkpointPath, { force: true })
+
+    return super.download(url, destination)
+  }
+
+  /**
+   * Downloads the segments of a new download, saving checkpoints while doing so.
+   */
+  protected override async downloadFile(
+    file: fs.promises.FileHandle,
+    probe: RangeDownloadProbe,
+    segments: RangeDownloadSegment[],
+    url: string,
+    destination: string,
+  ): Promise<void> {
+    const checkpoint: DownloadCheckpoint = {
+      version: 1,
+      requestedUrl: url,
+      ...probe,
+      segments,
+    }
+
+    await this.downloadWithCheckpoints(
+      checkpoint,
+      file,
+      this.getCheckpointPath(destination),
+    )
+  }
+
+  protected getCheckpointPath(destination: string) {
+    return this.options.getCheckpointPath
+      ? this.options.getCheckpointPath(destination)
+      : `${destination}.checkpoint.json`
+  }
+
+  private async resume(
+    checkpoint: DownloadCheckpoint,
+    destination: string,
+    checkpointPath: string,
+  ): Promise<RangeDownloadResult> {
+    let file: fs.promises.FileHandle
+
+    try {
+      file = await fs.promises.open(destination, 'r+')
+    } catch {
+      // the partial file is gone, so it is the same as changed
+      throw new RangeDownloadChangedError(`${destination} does not exist`)
+    }
+
+    try {
+      const { size } = await file.stat()
+      if (size !== checkpoint.size) {
+        throw new RangeDownloadChangedError(
+          `${destination} does not match its checkpoint`,
+        )
+      }
+
+      await this.downloadWithCheckpoints(checkpoint, file, checkpointPath)
+
+      return this.toResult(checkpoint)
+    } finally {
+      await file.close()
+    }
+  }
+
+  private async downloadWithCheckpoints(
+    checkpoint: DownloadCheckpoint,
+    file: fs.promises.FileHandle,
+    checkpointPath: string,
+  ) {
+    // saves are chained, so they never write the file at the same time
+    let pendingSave = this.writeCheckpoint(checkpointPath, checkpoint)
+    const save = () => {
+      pendingSave = pendingSave.then(() =>
+        this.writeCheckpoint(checkpointPath, checkpoint),
+      )
+      return pendingSave
+    }
+
+    const interval = setInterval(save, this.options.checkpointInterval)
+    interval.unref()
+
+    try {
+      await this.downloadSegments(
+        checkpoint.url,
+        file.fd,
+        checkpoint.segments,
+        checkpoint.size,
+        checkpoint.etag || checkpoint.lastModified,
+      )
+    } catch (error) {
+      clearInterval(interval)
+
+      if (error instanceof RangeDownloadChangedError) {
+        await pendingSave
+        await fs.promises.rm(checkpointPath, { force: true })
+      } else {
+        await save()
+      }
+
+      throw error
+    }
+
+    clearInterval(interval)
+    await pendingSave
+
+    // nothing left to resume
+    await file.sync()
+    await fs.promises.rm(checkpointPath, { force: true })
+  }
+
+  private async readCheckpoint(
+    checkpointPath: string,
+    url: string,
+  ): Promise<DownloadCheckpoint | null> {
+    try {
+      const checkpoint = JSON.parse(
+        await fs.promises.readFile(checkpointPath, 'utf8'),
+      ) as DownloadCheckpoint
+
+      if (
+        checkpoint.version !== 1 ||
+        checkpoint.requestedUrl !== url ||
+        !Array.isArray(checkpoint.segments)
+      ) {
+        return null
+      }
+
+      // resuming without a validator could mix two different versions of the file
+      if (!checkpoint.etag && !checkpoint.lastModified) return null
+
+      return checkpoint
+    } catch {
+      return null
+    }
+  }
+
+  // Includes the bytes written by the transfers still running.
+  private async writeCheckpoint(
+    checkpointPath: string,
+    checkpoint: DownloadCheckpoint,
+  ) {
+    const contents: DownloadCheckpoint = {
+      ...checkpoint,
+      segments: checkpoint.segments.map((segment) => ({
+        ...segment,
+        bytesWritten:
+          segment.bytesWritten +
+          (this.activeSegments.get(segment)?.downloadFileBytesWritten || 0),
+      })),
+    }
+
+    // written to a temporary file first, so a crash never leaves it half written
+    const temporaryPath = `${checkpointPath}.tmp`
+    await fs.promises.writeFile(temporaryPath, JSON.stringify(contents))
+    await fs.promises.rename(temporaryPath, checkpointPath)
+  }
+
+  private toResult(checkpoint: DownloadCheckpoint): RangeDownloadResult {
+    const { url, size, acceptsRanges, etag, lastModified, segments } =
+      checkpoint
+    return { url, size, acceptsRanges, etag, lastModified, segments }
+  }
+}
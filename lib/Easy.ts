@@ -8,6 +8,7 @@ import './moduleSetup'
 
 import { Share } from './Share'
 import { CurlMime } from './CurlMime'
+import { HeaderList } from './HeaderList'
 import {
   CurlOptionName,
   DataCallbackOptions,
@@ -49,6 +50,8 @@ import { CurlSslVersion } from './enum/CurlSslVersion'
 import { CurlTimeCond } from './enum/CurlTimeCond'
 import { CurlUseSsl } from './enum/CurlUseSsl'
 import { CurlWsOptions } from './enum/CurlWs'
+import { ProgressCounter } from './enum/ProgressCounter'
+import { ReadBufferMode } from './enum/ReadBufferMode'
 import { SocketState } from './enum/SocketState'
 
 import { Curl } from './Curl'
@@ -63,6 +66,80 @@ export interface GetInfoReturn<DataType = number | string | null> {
 
 export type CurlInfoNameSpecific = 'CERTINFO'
 
+/**
+ * Options for {@link Easy.setProgressThrottle | `Easy#setProgressThrottle`}.
+ *
+ * The progress callback is called when any of the thresholds set is reached.
+ *
+ * @public
+ */
+export interface ProgressThrottleOptions {
+  /**
+   * Minimum time between two calls, in milliseconds.
+   */
+  interval?: number
+  /**
+   * Minimum number of bytes transferred, uploaded plus downloaded, between two calls.
+   */
+  bytes?: number
+  /**
+   * Minimum change in the percentage of the transfer done, from `0` to `100`, between two calls.
+   *  It has no effect while the size of the transfer is not known.
+   */
+  percentage?: number
+}
+
+/**
+ * Options for {@link Easy.setDebugLog | `Easy#setDebugLog`}.
+ *
+ * @public
+ */
+export interface DebugLogOptions {
+  /**
+   * Maximum number of entries kept, once full the oldest ones are overwritten.
+   *
+   * @defaultValue 1024
+   */
+  capacity?: number
+  /**
+   * Maximum number of bytes kept of each entry, the rest is truncated.
+   *
+   * @defaultValue 256
+   */
+  maxDataSize?: number
+  /**
+   * Types of debug output recorded.
+   *
+   * @defaultValue `[CurlInfoDebug.Text, CurlInfoDebug.HeaderIn, CurlInfoDebug.HeaderOut]`
+   */
+  types?: CurlInfoDebug[]
+}
+
+/**
+ * An entry of the debug log of a handle, see {@link Easy.drainDebugLog | `Easy#drainDebugLog`}.
+ *
+ * @public
+ */
+export interface DebugLogEntry {
+  /**
+   * When it was recorded, in nanoseconds, in the same clock used by `process.hrtime.bigint()`.
+   */
+  timestamp: bigint
+  /**
+   * {@link Easy.id | `id`} of the handle it was recorded by.
+   */
+  handleId: number
+  type: CurlInfoDebug
+  /**
+   * The data, up to {@link DebugLogOptions.maxDataSize | `maxDataSize`} bytes.
+   */
+  data: Buffer
+  /**
+   * Size of the data before it was truncated.
+   */
+  size: number
+}
+
 /**
  * `Easy` class that acts as an wrapper around the libcurl connection handle.
  * > [C++ source code](https://github.com/JCMais/node-libcurl/blob/master/src/Easy.cc)
@@ -114,7 +191,7 @@ declare class Easy {
   /**
    * This is the unique ID of the Easy handle.
    *
-   * This ID is also unique across threads.
+   * This ID is also unique across threads. It starts at `1`.
    */
   readonly id: number
 
@@ -134,6 +211,12 @@ declare class Easy {
 
   readonly isPausedSend: boolean
 
+  /**
+   * Number of bytes written to the file set with {@link setDownloadFile | `setDownloadFile`}
+   *  since it was set.
+   */
+  readonly downloadFileBytesWritten: number
+
   /**
    * You can set this to anything - Use it to bind some data to this Easy instance.
    *
@@ -183,7 +266,10 @@ declare class Easy {
    *
    * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
-  setOpt(option: StringListOptions, value: string[] | null): CurlCode
+  setOpt(
+    option: StringListOptions,
+    value: string[] | HeaderList | [...string[], HeaderList] | null,
+  ): CurlCode
   /**
    * Use {@link Curl.option|`Curl.option`} for predefined constants.
    *
@@ -363,6 +449,16 @@ declare class Easy {
    * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
   setOpt(option: 'STREAM_DEPENDS_E', value: Easy | null): CurlCode
+  /**
+   * Use {@link Curl.option|`Curl.option`} for predefined constants.
+   *
+   *
+   * Official libcurl documentation: [`curl_easy_setopt()`](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(
+    option: 'POSTFIELDS',
+    value: string | ArrayBuffer | ArrayBufferView | null,
+  ): CurlCode
   /**
    * Use {@link Curl.option|`Curl.option`} for predefined constants.
    *
@@ -694,6 +790,170 @@ declare class Easy {
    */
   unmonitorSocketEvents(): this
 
+  /**
+   * Enables or disables zero copy for binary option values.
+   *
+   * When enabled, a `Buffer`, `ArrayBuffer` or other `ArrayBufferView` given to `POSTFIELDS`
+   *  or to one of the `*_BLOB` options is not copied, libcurl reads directly from its memory instead.
+   * A reference to it is kept until the option is set again, or the handle is reset or closed.
+   *
+   * The contents of the buffer **MUST** not be changed while it is set,
+   *  and its `ArrayBuffer` must not be detached or transferred.
+   *
+   * This only affects values set after calling this method. It is disabled by default,
+   *  and it is kept when the handle is reset or duplicated.
+   */
+  setZeroCopy(enabled: boolean): this
+
+  /**
+   * Uploads the contents of the given buffers, in order, as if they were a single one.
+   *
+   * The data is read natively when libcurl asks for it, so there is no need to concatenate the buffers
+   *  nor to set a `READFUNCTION` callback. Rewinds requested by libcurl, like when following redirects
+   *  or retrying with authentication, are also handled. Each transfer of the handle uploads them
+   *  from the start.
+   *
+   * This also sets `INFILESIZE_LARGE` to the total size. If doing a `POST` instead of using `UPLOAD`,
+   *  set `POSTFIELDSIZE_LARGE` to it as well.
+   *
+   * The buffers are not copied, so their contents **MUST** not be changed while the upload is happening.
+   * A `READFUNCTION` callback, when set, takes precedence over this.
+   *
+   * Pass `null` to remove the buffers currently set, this also removes the file set with
+   *  {@link setUploadFile | `setUploadFile`}, and sets `INFILESIZE_LARGE` back to `-1`.
+   * They are also removed when the handle is reset, and are copied to duplicated handles.
+   */
+  setUploadBuffers(
+    buffers: ReadonlyArray<ArrayBuffer | ArrayBufferView> | null,
+  ): this
+
+  /**
+   * Uploads the contents of the file at the given path, or a range of it, by memory mapping it.
+   *
+   * The data is read natively when libcurl asks for it, with no syscall per chunk,
+   *  and rewinds requested by libcurl, like when following redirects or retrying with authentication, are free.
+   *  Each transfer of the handle uploads the range from the start.
+   *
+   * This also sets `INFILESIZE_LARGE` to the size of the range. If doing a `POST` instead of using `UPLOAD`,
+   *  set `POSTFIELDSIZE_LARGE` to it as well.
+   *
+   * The file **MUST** not be truncated while the upload is happening.
+   * A `READFUNCTION` callback, when set, takes precedence over this.
+   *
+   * This replaces the buffers set with {@link setUploadBuffers | `setUploadBuffers`}, and vice versa.
+   * Pass `null` to remove the file currently set, which also sets `INFILESIZE_LARGE` back to `-1`.
+   * It is also removed when the handle is reset, and is shared with duplicated handles.
+   *
+   * @param options.offset Where in the file to start reading from, defaults to `0`
+   * @param options.length How many bytes to upload, defaults to the rest of the file
+   */
+  setUploadFile(
+    path: string | null,
+    options?: { offset?: number; length?: number },
+  ): this
+
+  /**
+   * Writes the response body to the given file descriptor, starting at `offset`,
+   *  instead of passing it to the `WRITEFUNCTION` callback, which is not called while this is set.
+   *
+   * The data is written natively, without going through JavaScript.
+   * The writes are synchronous, so they block the event loop while the disk is busy,
+   *  even when the handle is inside a {@link Multi | `Multi`} handle.
+   * Use {@link downloadFileBytesWritten | `downloadFileBytesWritten`} to know how much was written.
+   *
+   * If `offset` is negative, the data is written at the current position of the file.
+   *
+   * The file descriptor is not closed by the handle, and is not copied to duplicated handles.
+   * Pass `null` to stop writing to it. It is also removed when the handle is reset.
+   */
+  setDownloadFile(fd: number | null, offset?: number): this
+
+  /**
+   * Sets how the `Buffer` passed to the `READFUNCTION` callback is created.
+   *
+   * By default a new `Buffer` is allocated for every call, see {@link ReadBufferMode | `ReadBufferMode`}
+   *  for the alternatives that avoid it.
+   *
+   * This is reset to {@link ReadBufferMode.Copy | `ReadBufferMode.Copy`} when the handle is reset,
+   *  together with the callback itself.
+   */
+  setReadBufferMode(mode: ReadBufferMode): this
+
+  /**
+   * Limits how often the `XFERINFOFUNCTION` and `PROGRESSFUNCTION` callbacks are called.
+   *
+   * libcurl calls them on every tick of the transfer, which can happen many times per millisecond
+   *  on fast connections. With a throttle set, ticks that do not reach any of its thresholds
+   *  return `0` to libcurl natively, without calling into JavaScript.
+   *
+   * The first and the last tick of a transfer are always passed to the callback,
+   *  and so are all the ticks while the handle is paused, as the callback may be the one resuming it.
+   *
+   * Pass `null` to call the callback on every tick again. This is also done when the handle is reset.
+   */
+  setProgressThrottle(options: ProgressThrottleOptions | null): this
+
+  /**
+   * Publishes the progress of the transfers of this handle to `array`, which is updated natively
+   *  on every tick of the transfer, without calling into JavaScript.
+   *
+   * The values are at the indexes in {@link ProgressCounter | `ProgressCounter`},
+   *  and the array must have at least {@link ProgressCounter.Count | `ProgressCounter.Count`} elements.
+   * If the array is backed by a `SharedArrayBuffer`, it can be read from other threads,
+   *  with `Atomics.load` in the case of a `BigInt64Array`.
+   *
+   * This sets `NOPROGRESS` to `false`, and it must not be set back to `true` while the counters are in use.
+   * Progress callbacks can still be set, and are called as usual.
+   *
+   * The array must not be transferred while it is set. Pass `null` to stop using it.
+   * It is also removed when the handle is reset, and is not copied to duplicated handles.
+   */
+  setProgressCounters(array: Float64Array | BigInt64Array | null): this
+
+  /**
+   * Records the debug output of libcurl, what is printed with `VERBOSE`, natively,
+   *  to a ring with a fixed size, so it can be kept enabled without calling into JavaScript for every line.
+   * Use {@link drainDebugLog | `drainDebugLog`} to read the entries recorded,
+   *  for example after each request finishes.
+   *
+   * This enables `VERBOSE`, which is disabled again when the log is removed, unless it was set with `setOpt`.
+   * A `DEBUGFUNCTION` callback can still be set, and is called as usual.
+   *
+   * Pass `null` to remove the log. It is also removed when the handle is reset, and is not copied to duplicated handles.
+   */
+  setDebugLog(options: DebugLogOptions | null): this
+
+  /**
+   * Returns the entries recorded by the debug log since the last call, from oldest to newest,
+   *  and how many were overwritten before they could be read.
+   *
+   * Throws if {@link setDebugLog | `setDebugLog`} was not called.
+   */
+  drainDebugLog(): { entries: DebugLogEntry[]; dropped: number }
+
+  /**
+   * Cancels the transfer of this handle.
+   *
+   * The cancellation is checked natively by the data, header, read, seek and progress callbacks,
+   *  so the transfer stops on its next callback, even if no JavaScript callback is set.
+   * If the handle is inside a {@link Multi | `Multi`} handle, it is also removed from it right away,
+   *  or as soon as possible if this is called from one of its callbacks.
+   *
+   * The transfer fails with `CURLE_ABORTED_BY_CALLBACK`, and `reason`, if given,
+   *  is used as the `cause` of the error rejecting {@link Multi.perform | `Multi#perform`}.
+   *
+   * If no transfer is running, the next one fails right away.
+   */
+  cancel(reason?: Error): this
+
+  /**
+   * Cancels the transfer of this handle with {@link cancel | `cancel`} once `signal` is aborted,
+   *  using its `reason`. If it was already aborted, the handle is cancelled right away.
+   *
+   * Only one signal can be set at a time, pass `null` to remove it.
+   */
+  setAbortSignal(signal: AbortSignal | null): this
+
   /**
    * Build and set a MIME structure from a declarative configuration.
    *
@@ -860,4 +1120,47 @@ Easy.prototype.setMimePost = function (
   return this
 }
 
+const abortSignals = new WeakMap<
+  Easy,
+  { signal: AbortSignal; listener: () => void }
+>()
+
+/**
+ * Cancels the transfer of this handle once `signal` is aborted.
+ *
+ * @param signal The signal to watch, or `null` to remove the current one
+ * @returns This Easy instance for method chaining
+ */
+Easy.prototype.setAbortSignal = function (
+  this: Easy,
+  signal: AbortSignal | null,
+): Easy {
+  const current = abortSignals.get(this)
+  if (current) {
+    current.signal.removeEventListener('abort', current.listener)
+    abortSignals.delete(this)
+  }
+
+  if (!signal) return this
+
+  const listener = () => {
+    abortSignals.delete(this)
+
+    if (!this.isOpen) return
+
+    const { reason } = signal
+    this.cancel(reason instanceof Error ? reason : new Error(String(reason)))
+  }
+
+  if (signal.aborted) {
+    listener()
+    return this
+  }
+
+  signal.addEventListener('abort', listener, { once: true })
+  abortSignals.set(this, { signal, listener })
+
+  return this
+}
+
 export { Easy }
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import './moduleSetup'
+
+/**
+ * `HeaderList` is an immutable native `curl_slist` that is built only once,
+ *  and can then be used with any of the options that take a list of strings,
+ *  like `HTTPHEADER`, on any number of handles, without being copied again.
+ * > [C++ source code](https://github.com/JCMais/node-libcurl/blob/master/src/HeaderList.cc)
+ *
+ * The list is kept alive by the handles using it, so it is fine for the
+ *  `HeaderList` instance itself to be garbage collected while they are still in use.
+ *
+ * Headers that change on every request can be passed in an array, with the
+ *  `HeaderList` as its last item. Only the items before it are allocated for that handle.
+ *
+ * @example
+ * ```typescript
+ * import { Curl, HeaderList } from 'node-libcurl'
+ *
+ * const commonHeaders = new HeaderList([
+ *   'Accept: application/json',
+ *   'User-Agent: my-service/1.0',
+ * ])
+ *
+ * const curl = new Curl()
+ * curl.setOpt('HTTPHEADER', commonHeaders)
+ *
+ * // or, with per request headers:
+ * curl.setOpt('HTTPHEADER', [`X-Request-Id: ${requestId}`, commonHeaders])
+ * ```
+ *
+ * @public
+ */
+// @ts-expect-error - we are abusing TS merging here to have sane types for the addon classes
+declare class HeaderList {
+  /**
+   * Creates the native list from the given strings.
+   */
+  constructor(items: string[])
+
+  /**
+   * Number of items in this list.
+   */
+  readonly length: number
+
+  /**
+   * Returns a copy of the items in this list.
+   */
+  toArray(): string[]
+}
+
+const bindings: any = require('../lib/binding/node_libcurl.node')
+
+// @ts-expect-error - we are abusing TS merging here to have sane types for the addon classes
+const HeaderList = bindings.HeaderList as typeof HeaderList
+
+export { HeaderList }
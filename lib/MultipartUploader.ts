@@ -0,0 +1,350 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import './moduleSetup'
+
+import fs from 'fs'
+
+import { Easy } from './Easy'
+import { Multi } from './Multi'
+import { CurlCode } from './enum/CurlCode'
+
+/**
+ * A part of the file being uploaded by {@link MultipartUploader | `MultipartUploader`}.
+ *
+ * @public
+ */
+export interface MultipartUploadPart {
+  /**
+   * Number of this part, starting at `1`, like in S3 compatible APIs.
+   */
+  partNumber: number
+  /**
+   * Offset of the first byte of this part in the file.
+   */
+  offset: number
+  length: number
+  /**
+   * `ETag` header returned by the server for this part, once it was uploaded.
+   */
+  etag: string | null
+  /**
+   * How many attempts were needed to upload this part.
+   */
+  attempts: number
+}
+
+/**
+ * @public
+ */
+export interface MultipartUploaderOptions {
+  /**
+   * Called with the handle used for each attempt to upload a part.
+   *
+   * It must set at least the `URL` of the part, and the options needed to authenticate the request.
+   * The body, `UPLOAD` and `INFILESIZE_LARGE` options are set by the uploader.
+   * The `HEADERFUNCTION` and `WRITEFUNCTION` options must not be changed.
+   */
+  setupPartHandle: (
+    handle: Easy,
+    part: MultipartUploadPart,
+  ) => void | Promise<void>
+
+  /**
+   * Size of each part, in bytes. The last one can be smaller.
+   *
+   * @defaultValue 8 MiB
+   */
+  partSize?: number
+
+  /**
+   * How many parts are uploaded at the same time.
+   *
+   * @defaultValue 4
+   */
+  concurrency?: number
+
+  /**
+   * How many times a part is retried after failing with a retryable error,
+   *  see {@link MultipartUploader.isRetryable | `isRetryable`}.
+   *
+   * @defaultValue 3
+   */
+  maxRetries?: number
+
+  /**
+   * Delay before the first retry of a part, in milliseconds. It doubles on every retry.
+   *
+   * @defaultValue 250
+   */
+  retryDelay?: number
+
+  /**
+   * `Multi` instance used to run the transfers.
+   *
+   * By default one is created, and closed by {@link MultipartUploader.close | `close`}.
+   */
+  multi?: Multi
+
+  /**
+   * Called once each part finishes uploading.
+   */
+  onPartEnd?: (part: MultipartUploadPart) => void
+}
+
+/**
+ * Error thrown when a part could not be uploaded.
+ *
+ * @public
+ */
+export class MultipartUploadError extends Error {
+  static override readonly name: string = 'MultipartUploadError'
+
+  constructor(
+    message: string,
+    readonly part: MultipartUploadPart,
+    /**
+     * HTTP status code of the last attempt, or `0` if there was no response.
+     */
+    readonly statusCode: number,
+    /**
+     * Result of the last attempt.
+     */
+    readonly code: CurlCode,
+    errorOptions?: ErrorOptions,
+  ) {
+    super(message, errorOptions)
+  }
+}
+
+const retryableCurlCodes = new Set<CurlCode>([
+  CurlCode.CURLE_COULDNT_RESOLVE_HOST,
+  CurlCode.CURLE_COULDNT_CONNECT,
+  CurlCode.CURLE_HTTP2,
+  CurlCode.CURLE_PARTIAL_FILE,
+  CurlCode.CURLE_OPERATION_TIMEDOUT,
+  CurlCode.CURLE_SSL_CONNECT_ERROR,
+  CurlCode.CURLE_GOT_NOTHING,
+  CurlCode.CURLE_SEND_ERROR,
+  CurlCode.CURLE_RECV_ERROR,
+  CurlCode.CURLE_HTTP2_STREAM,
+])
+
+/**
+ * `MultipartUploader` uploads a file in parts, concurrently, through a single `Multi` handle,
+ *  like the multipart upload API of S3 and compatible services.
+ *
+ * The body of each part is read natively from a memory mapping of its range of the file,
+ *  with {@link Easy.setUploadFile | `Easy#setUploadFile`}, so the data never goes through JavaScript.
+ *
+ * Parts failing with a retryable error are retried, and the `ETag` returned for each part
+ *  is collected, so they can be sent in the request completing the upload.
+ *
+ * @example
+ * ```typescript
+ * import { MultipartUploader } from 'node-libcurl'
+ *
+ * const uploader = new MultipartUploader({
+ *   partSize: 16 * 1024 * 1024,
+ *   setupPartHandle: (handle, part) => {
+ *     handle.setOpt(
+ *       'URL',
+ *       `${uploadUrl}?partNumber=${part.partNumber}&uploadId=${uploadId}`,
+ *     )
+ *     handle.setOpt('HTTPHEADER', [`Authorization: ${token}`])
+ *   },
+ * })
+ *
+ * try {
+ *   const parts = await uploader.upload('./artifact.tar')
+ *   // complete the upload using parts[i].partNumber and parts[i].etag
+ * } finally {
+ *   uploader.close()
+ * }
+ * ```
+ *
+ * @public
+ */
+export class MultipartUploader {
+  protected readonly options: MultipartUploaderOptions &
+    Required<
+      Pick<
+        MultipartUploaderOptions,
+        'partSize' | 'concurrency' | 'maxRetries' | 'retryDelay'
+      >
+    >
+
+  protected readonly multi: Multi
+
+  private readonly isMultiOwned: boolean
+
+  constructor(options: MultipartUploaderOptions) {
+    this.options = {
+      partSize: 8 * 1024 * 1024,
+      concurrency: 4,
+      maxRetries: 3,
+      retryDelay: 250,
+      ...options,
+    }
+
+    this.isMultiOwned = !options.multi
+    this.multi = options.multi || new Multi()
+  }
+
+  /**
+   * Uploads the file at `path`, returning its parts ordered by their number.
+   *
+   * If a part cannot be uploaded, no other part is started or retried, and once the ones
+   *  already being uploaded finish, a {@link MultipartUploadError | `MultipartUploadError`} is thrown.
+   */
+  async upload(path: string): Promise<MultipartUploadPart[]> {
+    const { size } = await fs.promises.stat(path)
+    const parts = MultipartUploader.splitParts(size, this.options.partSize)
+
+    let nextPart = 0
+    let failure: unknown = null
+    const hasFailed = () => failure !== null
+
+    const worker = async () => {
+      while (nextPart < parts.length && !hasFailed()) {
+        const part = parts[nextPart++]
+
+        try {
+          await this.uploadPart(path, part, hasFailed)
+          this.options.onPartEnd?.(part)
+        } catch (error) {
+          failure = failure || error
+        }
+      }
+    }
+
+    const workers = Array.from(
+      { length: Math.max(1, Math.min(this.options.concurrency, parts.length)) },
+      worker,
+    )
+    await Promise.all(workers)
+
+    if (failure) throw failure
+
+    return parts
+  }
+
+  /**
+   * Closes the `Multi` instance, if it was created by this uploader.
+   */
+  close() {
+    if (this.isMultiOwned) this.multi.close()
+  }
+
+  /**
+   * Returns if a failed attempt to upload a part should be retried.
+   *
+   * By default, connection errors, timeouts, `429` responses and `5xx` responses are retried.
+   */
+  protected isRetryable(statusCode: number, code: CurlCode) {
+    if (code !== CurlCode.CURLE_OK) return retryableCurlCodes.has(code)
+
+    return statusCode === 429 || statusCode >= 500
+  }
+
+  /**
+   * Splits `size` bytes in parts of `partSize` bytes, the last one can be smaller.
+   *
+   * An empty file still has a single, empty, part.
+   */
+  static splitParts(size: number, partSize: number): MultipartUploadPart[] {
+    const parts: MultipartUploadPart[] = []
+    const count = Math.max(1, Math.ceil(size / partSize))
+
+    for (let i = 0; i < count; i += 1) {
+      const offset = i * partSize
+      parts.push({
+        partNumber: i + 1,
+        offset,
+        length: Math.min(partSize, size - offset),
+        etag: null,
+        attempts: 0,
+      })
+    }
+
+    return parts
+  }
+
+  private async uploadPart(
+    path: string,
+    part: MultipartUploadPart,
+    hasFailed: () => boolean,
+  ) {
+    for (;;) {
+      part.attempts += 1
+
+      const handle = new Easy()
+
+      let statusCode = 0
+      let code = CurlCode.CURLE_OK
+      let etag: string | null = null
+      let cause: unknown
+
+      try {
+        await this.options.setupPartHandle(handle, part)
+
+        handle.setOpt('UPLOAD', true)
+        handle.setUploadFile(path, { offset: part.offset, length: part.length })
+        handle.setOpt('HEADERFUNCTION', (data, size, nmemb) => {
+          const line = data.toString('latin1')
+
+          if (/^HTTP\//i.test(line)) {
+            etag = null
+          } else if (/^etag:/i.test(line)) {
+            etag = line.slice(5).trim()
+          }
+
+          return size * nmemb
+        })
+
+        try {
+          await this.multi.perform(handle)
+        } catch (error) {
+          cause = error
+          code =
+            (error as { code?: CurlCode }).code ?? CurlCode.CURLE_SEND_ERROR
+        }
+
+        statusCode = handle.getInfo('RESPONSE_CODE').data as number
+      } finally {
+        // deferred like in Curl#perform, see issue #439
+        if (handle.isInsideMultiHandle) {
+          await new Promise(setImmediate)
+          this.multi.removeHandle(handle)
+        }
+        handle.close()
+      }
+
+      if (code === CurlCode.CURLE_OK && statusCode >= 200 && statusCode < 300) {
+        part.etag = etag
+        return
+      }
+
+      // another part failed, so the upload is going to fail anyway
+      if (
+        hasFailed() ||
+        part.attempts > this.options.maxRetries ||
+        !this.isRetryable(statusCode, code)
+      ) {
+        throw new MultipartUploadError(
+          `Could not upload part ${part.partNumber}, status code ${statusCode}`,
+          part,
+          statusCode,
+          code,
+          { cause },
+        )
+      }
+
+      const delay = this.options.retryDelay * 2 ** (part.attempts - 1)
+      await new Promise((resolve) => setTimeout(resolve, delay))
+    }
+  }
+}
@@ -0,0 +1,472 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import './moduleSetup'
+
+import fs from 'fs'
+
+import { Easy } from './Easy'
+import { Multi } from './Multi'
+
+/**
+ * A byte range of the file being downloaded by {@link RangeDownloader | `RangeDownloader`}.
+ *
+ * @public
+ */
+export interface RangeDownloadSegment {
+  /**
+   * Offset of the first byte of this segment.
+   */
+  start: number
+  /**
+   * Offset of the last byte of this segment, inclusive, like in the `Range` header.
+   */
+  end: number
+  /**
+   * How many bytes of this segment were already written to the file.
+   */
+  bytesWritten: number
+}
+
+/**
+ * What is known about a remote file before downloading it,
+ *  see {@link RangeDownloader.probe | `RangeDownloader#probe`}.
+ *
+ * @public
+ */
+export interface RangeDownloadProbe {
+  /**
+   * URL after following redirects, the segments are requested from it directly.
+   */
+  url: string
+  /**
+   * Size of the file, in bytes.
+   */
+  size: number
+  /**
+   * If `false`, the server ignored the `Range` header, and the whole file was already
+   *  written while probing it.
+   */
+  acceptsRanges: boolean
+  etag: string | null
+  lastModified: string | null
+}
+
+/**
+ * @public
+ */
+export interface RangeDownloadResult extends RangeDownloadProbe {
+  segments: RangeDownloadSegment[]
+}
+
+/**
+ * @public
+ */
+export interface RangeDownloaderOptions {
+  /**
+   * Maximum number of segments the file is split in, which is also
+   *  the maximum number of concurrent connections.
+   *
+   * @defaultValue 8
+   */
+  connections?: number
+
+  /**
+   * The file is not split in segments smaller than this, in bytes.
+   *
+   * @defaultValue 1 MiB
+   */
+  minSegmentSize?: number
+
+  /**
+   * Headers to send with every request.
+   */
+  headers?: string[]
+
+  /**
+   * Called with every handle before its request starts, use it to set other options,
+   *  like authentication, proxies or TLS ones.
+   *
+   * The `URL`, `RANGE`, `HTTPHEADER`, `FAILONERROR` and `HEADERFUNCTION` options
+   *  are set by the downloader, and must not be changed.
+   */
+  setupHandle?: (handle: Easy) => void
+
+  /**
+   * `Multi` instance used to run the transfers.
+   *
+   * By default one is created, and closed by {@link RangeDownloader.close | `close`}.
+   */
+  multi?: Multi
+
+  /**
+   * Called once each segment finishes downloading.
+   */
+  onSegmentEnd?: (
+    segment: RangeDownloadSegment,
+    bytesWritten: number,
+    size: number,
+  ) => void
+}
+
+/**
+ * Error thrown when the file changed on the server in the middle of a download.
+ *
+ * @public
+ */
+export class RangeDownloadChangedError extends Error {
+  static override readonly name: string = 'RangeDownloadChangedError'
+}
+
+interface TrackedHandle {
+  handle: Easy
+  status: number
+  headers: string[]
+}
+
+const parseHeader = (headers: string[], name: string) => {
+  const prefix = `${name.toLowerCase()}:`
+  const header = headers.find((line) => line.toLowerCase().startsWith(prefix))
+  return header ? header.slice(prefix.length).trim() : null
+}
+
+/**
+ * `RangeDownloader` downloads a file using multiple concurrent connections,
+ *  each one requesting a different byte range of it with the `RANGE` option.
+ *
+ * The segments are written straight to their offset in the destination file
+ *  by the native addon, using {@link Easy.setDownloadFile | `Easy#setDownloadFile`},
+ *  so the data never goes through JavaScript. Those writes are synchronous, and block the event loop
+ *  while the disk is busy.
+ *
+ * If the server does not support range requests, the file is downloaded using a single connection.
+ *
+ * @example
+ * ```typescript
+ * import { RangeDownloader } from 'node-libcurl'
+ *
+ * const downloader = new RangeDownloader({ connections: 8 })
+ *
+ * try {
+ *   const { size } = await downloader.download('https://example.com/file.bin', './file.bin')
+ * } finally {
+ *   downloader.close()
+ * }
+ * ```
+ *
+ * @public
+ */
+export class RangeDownloader {
+  protected readonly options: RangeDownloaderOptions &
+    Required<Pick<RangeDownloaderOptions, 'connections' | 'minSegmentSize'>>
+
+  protected readonly multi: Multi
+
+  private readonly isMultiOwned: boolean
+
+  /**
+   * Handles of the segments currently being downloaded,
+   *  their `downloadFileBytesWritten` is not yet added to the segment `bytesWritten`.
+   */
+  protected readonly activeSegments = new Map<RangeDownloadSegment, Easy>()
+
+  constructor(options: RangeDownloaderOptions = {}) {
+    this.options = {
+      connections: 8,
+      minSegmentSize: 1024 * 1024,
+      ...options,
+    }
+
+    this.isMultiOwned = !options.multi
+    this.multi = options.multi || new Multi()
+  }
+
+  /**
+   * Downloads the file at `url` to `destination`, which is overwritten if it already exists.
+   */
+  async download(
+    url: string,
+    destination: string,
+  ): Promise<RangeDownloadResult> {
+    const file = await fs.promises.open(destination, 'w')
+
+    try {
+      const probe = await this.probe(url, file.fd)
+
+      if (!probe.acceptsRanges) {
+        return {
+          ...probe,
+          segments: [
+            { start: 0, end: probe.size - 1, bytesWritten: probe.size },
+          ],
+        }
+      }
+
+      // allocate the whole file upfront, so segments can be written in any order
+      await file.truncate(probe.size)
+
+      const segments = RangeDownloader.splitRanges(
+        probe.size,
+        this.options.connections,
+        this.options.minSegmentSize,
+      )
+
+      await this.downloadFile(file, probe, segments, url, destination)
+
+      return { ...probe, segments }
+    } finally {
+      await file.close()
+    }
+  }
+
+  /**
+   * Called by {@link download | `download`} once the file was probed and allocated,
+   *  to download all its `segments` to `file`.
+   *
+   * Subclasses can override it to keep track of the segments while they are downloaded,
+   *  like {@link DownloadManager | `DownloadManager`} does with its checkpoints.
+   *  They also get the `url` (before following redirects) and `destination` passed to `download`.
+   */
+  protected async downloadFile(
+    file: fs.promises.FileHandle,
+    probe: RangeDownloadProbe,
+    segments: RangeDownloadSegment[],
+    _url: string,
+    _destination: string,
+  ): Promise<void> {
+    await this.downloadSegments(
+      probe.url,
+      file.fd,
+      segments,
+      probe.size,
+      probe.etag || probe.lastModified,
+    )
+  }
+
+  /**
+   * Requests the first byte of the file, to find out its size, validators,
+   *  and if the server supports range requests.
+   *
+   * The response body is written to `fd`, so if the server ignores the range,
+   *  the whole file is downloaded by this request.
+   */
+  async probe(url: string, fd: number): Promise<RangeDownloadProbe> {
+    const tracked = this.createHandle(url, (status) =>
+      [200, 206].includes(status),
+    )
+    const { handle } = tracked
+
+    try {
+      handle.setOpt('RANGE', '0-0')
+      handle.setDownloadFile(fd, 0)
+
+      try {
+        await this.multi.perform(handle)
+      } catch (error) {
+        // empty files cannot satisfy any range
+        if (tracked.status !== 416) throw error
+      }
+
+      if (![200, 206, 416].includes(tracked.status)) {
+        throw new Error(
+          `Unexpected status code ${tracked.status} when probing ${url}`,
+        )
+      }
+
+      const acceptsRanges = tracked.status !== 200
+      const contentRange = parseHeader(tracked.headers, 'Content-Range')
+      const totalMatch = contentRange && /\/(\d+)$/.exec(contentRange)
+
+      if (acceptsRanges && !totalMatch) {
+        throw new Error(`Missing the file size in the response from ${url}`)
+      }
+
+      return {
+        url: (handle.getInfo('EFFECTIVE_URL').data as string) || url,
+        size: totalMatch
+          ? parseInt(totalMatch[1], 10)
+          : handle.downloadFileBytesWritten,
+        acceptsRanges,
+        etag: parseHeader(tracked.headers, 'ETag'),
+        lastModified: parseHeader(tracked.headers, 'Last-Modified'),
+      }
+    } finally {
+      await this.removeFromMulti([handle])
+      handle.close()
+    }
+  }
+
+  /**
+   * Downloads the remaining bytes of each segment concurrently, writing them to `fd`,
+   *  and updating their `bytesWritten`.
+   *
+   * If `validator` is set, it is sent in the `If-Range` header,
+   *  and a {@link RangeDownloadChangedError | `RangeDownloadChangedError`} is thrown
+   *  if the file does not match it anymore.
+   *
+   * If one of the segments fails, the others are stopped, and the error is thrown.
+   */
+  async downloadSegments(
+    url: string,
+    fd: number,
+    segments: RangeDownloadSegment[],
+    size: number,
+    validator: string | null = null,
+  ): Promise<void> {
+    const handles: Easy[] = []
+    let totalWritten = segments.reduce((sum, s) => sum + s.bytesWritten, 0)
+
+    const transfers = segments
+      .filter((segment) => segment.start + segment.bytesWritten <= segment.end)
+      .map(async (segment) => {
+        const tracked = this.createHandle(
+          url,
+          (status) => status === 206,
+          validator ? [`If-Range: ${validator}`] : [],
+        )
+        const { handle } = tracked
+        handles.push(handle)
+
+        const start = segment.start + segment.bytesWritten
+
+        handle.setOpt('RANGE', `${start}-${segment.end}`)
+        handle.setOpt('FAILONERROR', true)
+        handle.setDownloadFile(fd, start)
+
+        this.activeSegments.set(segment, handle)
+
+        try {
+          await this.multi.perform(handle)
+        } catch (error) {
+          if (tracked.status === 200 && validator) {
+            throw new RangeDownloadChangedError(
+              `The file at ${url} changed while it was being downloaded`,
+            )
+          }
+          throw error
+        } finally {
+          this.activeSegments.delete(segment)
+          segment.bytesWritten += handle.downloadFileBytesWritten
+          totalWritten += handle.downloadFileBytesWritten
+        }
+
+        if (tracked.status !== 206) {
+          throw new Error(
+            `Unexpected status code ${tracked.status} when downloading ${url}`,
+          )
+        }
+
+        if (segment.start + segment.bytesWritten !== segment.end + 1) {
+          throw new Error(
+            `Segment ${segment.start}-${segment.end} of ${url} ended early`,
+          )
+        }
+
+        this.options.onSegmentEnd?.(segment, totalWritten, size)
+      })
+
+    try {
+      await Promise.all(transfers)
+    } catch (error) {
+      // this rejects the transfers still running
+      await this.removeFromMulti(handles)
+      await Promise.allSettled(transfers)
+      throw error
+    } finally {
+      await this.removeFromMulti(handles)
+      for (const handle of handles) handle.close()
+    }
+  }
+
+  // Finished handles are kept inside the Multi handle until they are removed.
+  // This is deferred like in Curl#perform, as perform() can settle while libcurl
+  //  is still in its own call stack, see issue #439.
+  protected async removeFromMulti(handles: Easy[]) {
+    if (!handles.some((handle) => handle.isInsideMultiHandle)) return
+
+    await new Promise(setImmediate)
+
+    for (const handle of handles) {
+      if (handle.isInsideMultiHandle) this.multi.removeHandle(handle)
+    }
+  }
+
+  /**
+   * Closes the `Multi` instance, if it was created by this downloader.
+   */
+  close() {
+    if (this.isMultiOwned) this.multi.close()
+  }
+
+  /**
+   * Splits `size` bytes in up to `connections` segments of about the same size,
+   *  none smaller than `minSegmentSize`.
+   */
+  static splitRanges(
+    size: number,
+    connections: number,
+    minSegmentSize: number,
+  ): RangeDownloadSegment[] {
+    if (size <= 0) return []
+
+    const count = Math.max(
+      1,
+      Math.min(connections, Math.floor(size / Math.max(minSegmentSize, 1))),
+    )
+    const segmentSize = Math.floor(size / count)
+    const segments: RangeDownloadSegment[] = []
+
+    for (let i = 0; i < count; i += 1) {
+      const start = i * segmentSize
+      // the last one also takes what is left from the division
+      const end = i === count - 1 ? size - 1 : start + segmentSize - 1
+      segments.push({ start, end, bytesWritten: 0 })
+    }
+
+    return segments
+  }
+
+  // Creates a handle that keeps the headers and status code of the last response,
+  // aborting the transfer before the body is written if the status is not accepted.
+  private createHandle(
+    url: string,
+    isStatusAccepted: (status: number) => boolean,
+    extraHeaders: string[] = [],
+  ): TrackedHandle {
+    const handle = new Easy()
+    const tracked: TrackedHandle = { handle, status: 0, headers: [] }
+
+    this.options.setupHandle?.(handle)
+
+    handle.setOpt('URL', url)
+    handle.setOpt('HTTPHEADER', [
+      ...(this.options.headers || []),
+      ...extraHeaders,
+    ])
+    handle.setOpt('HEADERFUNCTION', (data, size, nmemb) => {
+      const line = data.toString('latin1').trim()
+
+      if (/^HTTP\//i.test(line)) {
+        // there can be more than one response, like when following redirects
+        tracked.headers = []
+      } else if (line === '') {
+        const status = handle.getInfo('RESPONSE_CODE').data as number
+
+        // informational responses and redirects are followed by the real one
+        if (status >= 200 && (status < 300 || status >= 400)) {
+          tracked.status = status
+          if (!isStatusAccepted(status)) return -1
+        }
+      } else {
+        tracked.headers.push(line)
+      }
+
+      return size * nmemb
+    })
+
+    return tracked
+  }
+}
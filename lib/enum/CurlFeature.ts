@@ -91,4 +91,14 @@ export enum CurlFeature {
    * Versions older than that one are not reliable for streams usage.
    */
   StreamResponse = 1 << 4,
+
+  /**
+   * Binary values given to `POSTFIELDS` and to the `*_BLOB` options are used directly by libcurl,
+   *  instead of being copied. The buffer **MUST** not be changed while it is set.
+   *
+   * See {@link Easy.setZeroCopy | `Easy#setZeroCopy`} for details.
+   *
+   * This must be enabled before setting the options.
+   */
+  ZeroCopyBuffers = 1 << 5,
 }
@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { Easy } from '../Easy'
+import { TransferPhase } from './TransferPhase'
+/**
+ * Index of each value in the array passed to {@link Easy.setProgressCounters | `Easy#setProgressCounters`}.
+ *
+ * @public
+ */
+export enum ProgressCounter {
+  /**
+   * Total number of bytes expected to be downloaded, `0` if not known.
+   */
+  DownloadTotal = 0,
+  /**
+   * Number of bytes downloaded so far.
+   */
+  DownloadNow = 1,
+  /**
+   * Total number of bytes expected to be uploaded, `0` if not known.
+   */
+  UploadTotal = 2,
+  /**
+   * Number of bytes uploaded so far.
+   */
+  UploadNow = 3,
+  /**
+   * Average download speed, in bytes per second, like `getInfo('SPEED_DOWNLOAD_T')`.
+   */
+  DownloadSpeed = 4,
+  /**
+   * Average upload speed, in bytes per second, like `getInfo('SPEED_UPLOAD_T')`.
+   */
+  UploadSpeed = 5,
+  /**
+   * Current {@link TransferPhase | `TransferPhase`} of the transfer.
+   */
+  Phase = 6,
+  /**
+   * Minimum length of the array.
+   */
+  Count = 7,
+}
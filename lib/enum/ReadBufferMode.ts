@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { Easy } from '../Easy'
+/**
+ * How the `Buffer` passed to the `READFUNCTION` callback is created.
+ *
+ * See {@link Easy.setReadBufferMode | `Easy#setReadBufferMode`}.
+ *
+ * @public
+ */
+export enum ReadBufferMode {
+  /**
+   * A new `Buffer` is allocated for each call, and its contents are copied to libcurl after it returns.
+   *
+   * This is the default.
+   */
+  Copy = 0,
+
+  /**
+   * The same `Buffer` is reused by all the calls made for the handle, its contents are copied to libcurl after it returns.
+   *
+   * The callback must not keep a reference to the `Buffer`, as its contents are overwritten on the next call.
+   */
+  Pooled = 1,
+
+  /**
+   * The `Buffer` is backed by libcurl's own upload buffer, so nothing needs to be copied after the callback returns.
+   *
+   * The `Buffer` is only valid during the call, it is detached right after it, having a length of zero.
+   * If the runtime does not allow external buffers, like Electron, this behaves like `Pooled`.
+   */
+  Borrowed = 2,
+}
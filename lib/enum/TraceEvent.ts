@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import type { Curl, TraceRecord } from '../Curl'
+import type { Easy } from '../Easy'
+import type { Multi } from '../Multi'
+import type { CurlCode } from './CurlCode'
+/**
+ * Events recorded by the internal trace, see {@link Curl.setTraceEnabled | `Curl.setTraceEnabled`}.
+ *
+ * The meaning of {@link TraceRecord.value | `TraceRecord#value`} depends on the event.
+ *
+ * @public
+ */
+export enum TraceEvent {
+  /**
+   * An Easy handle was added to a Multi handle.
+   */
+  MultiAddHandle = 1,
+  /**
+   * An Easy handle was removed from a Multi handle.
+   */
+  MultiRemoveHandle = 2,
+  /**
+   * The transfer of an Easy handle was cancelled while inside a Multi handle.
+   */
+  MultiCancelHandle = 3,
+  /**
+   * libcurl asked to change what is polled on a socket.
+   *
+   * `value` is the `CURL_POLL_*` action, `socket` is the socket.
+   */
+  MultiSocketAction = 4,
+  /**
+   * libcurl asked to change the timer of the Multi handle.
+   *
+   * `value` is the timeout in milliseconds, `-1` if the timer was stopped.
+   */
+  MultiTimerSet = 5,
+  /**
+   * The timer of the Multi handle expired, `duration` is the time spent handling it.
+   */
+  MultiOnTimeout = 6,
+  /**
+   * A socket of the Multi handle is ready, `duration` is the time spent handling it.
+   *
+   * `value` is the libuv poll events, `1` readable, `2` writable.
+   */
+  MultiOnSocket = 7,
+  /**
+   * The messages of the Multi handle were read, `duration` includes the `onMessage` callbacks.
+   *
+   * `value` is the number of messages read.
+   */
+  MultiProcessMessages = 8,
+  /**
+   * The transfer of an Easy handle inside a Multi handle finished.
+   *
+   * `value` is its {@link CurlCode | `CurlCode`}.
+   */
+  MultiTransferDone = 9,
+  /**
+   * A blocking {@link Easy.perform | `Easy#perform`} call, `duration` is the whole transfer.
+   *
+   * `value` is its {@link CurlCode | `CurlCode`}.
+   */
+  EasyPerform = 10,
+  /**
+   * A JavaScript callback of an Easy handle was called, `duration` is the time spent on it.
+   *
+   * `value` is the {@link TraceCallback | `TraceCallback`} called.
+   */
+  EasyCallback = 11,
+  /**
+   * A transfer started, either by {@link Easy.perform | `Easy#perform`}
+   *  or by adding the handle to a {@link Multi | `Multi`} handle.
+   */
+  EasyTransferStart = 12,
+  /**
+   * A transfer finished, `value` is its {@link CurlCode | `CurlCode`}.
+   */
+  EasyTransferEnd = 13,
+  /**
+   * One of the times reported by libcurl for a finished transfer.
+   *
+   * `value` is the {@link TraceTransferTime | `TraceTransferTime`},
+   *  `timestamp` is when the transfer started,
+   *  and `duration` is the time from then, as reported by libcurl.
+   */
+  EasyTransferTime = 14,
+}
+
+/**
+ * The JavaScript callbacks recorded by {@link TraceEvent.EasyCallback | `TraceEvent.EasyCallback`}.
+ *
+ * @public
+ */
+export enum TraceCallback {
+  ChunkBgn = 0,
+  ChunkEnd = 1,
+  Debug = 2,
+  FnMatch = 3,
+  Header = 4,
+  HstsRead = 5,
+  HstsWrite = 6,
+  Interleave = 7,
+  PreReq = 8,
+  Progress = 9,
+  Read = 10,
+  Seek = 11,
+  SshHostKey = 12,
+  Trailer = 13,
+  Write = 14,
+  Xferinfo = 15,
+}
+
+/**
+ * The times recorded by {@link TraceEvent.EasyTransferTime | `TraceEvent.EasyTransferTime`},
+ *  each one is the matching `CURLINFO_*_TIME_T` value.
+ *
+ * @public
+ */
+export enum TraceTransferTime {
+  /**
+   * Time spent waiting for a connection to be available, only with libcurl >= 8.6.0.
+   */
+  Queue = 0,
+  NameLookup = 1,
+  Connect = 2,
+  /**
+   * The TLS handshake was done, `0` for plain connections.
+   */
+  AppConnect = 3,
+  PreTransfer = 4,
+  /**
+   * The first byte of the response was received.
+   */
+  StartTransfer = 5,
+  Total = 6,
+}
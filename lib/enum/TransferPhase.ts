@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { Easy } from '../Easy'
+import { ProgressCounter } from './ProgressCounter'
+/**
+ * Phase of a transfer, as written to the {@link ProgressCounter.Phase | `ProgressCounter.Phase`} index
+ *  of the array passed to {@link Easy.setProgressCounters | `Easy#setProgressCounters`}.
+ *
+ * @public
+ */
+export enum TransferPhase {
+  /**
+   * No transfer was started since the counters were set.
+   */
+  Idle = 0,
+  /**
+   * The connection to the server is being established.
+   */
+  Connecting = 1,
+  /**
+   * The request body is being sent.
+   */
+  Sending = 2,
+  /**
+   * The request was sent, and the response body did not start yet.
+   */
+  Waiting = 3,
+  /**
+   * The response body is being received.
+   */
+  Receiving = 4,
+  /**
+   * The transfer finished successfully.
+   */
+  Done = 5,
+  /**
+   * The transfer failed, or was aborted.
+   */
+  Failed = 6,
+}
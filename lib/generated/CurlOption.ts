@@ -38,6 +38,7 @@ import { CurlWsOptions } from '../enum/CurlWs'
 import { Easy } from '../Easy'
 import { Share } from '../Share'
 import { CurlMime } from '../CurlMime'
+import { HeaderList } from '../HeaderList'
 
 /**
  * @public
@@ -4199,6 +4200,7 @@ export type SpecificOptions =
   | 'HTTPPOST'
   | 'STREAM_DEPENDS'
   | 'STREAM_DEPENDS_E'
+  | 'POSTFIELDS'
   | 'FTP_SSL_CCC'
   | 'FTP_FILEMETHOD'
   | 'GSSAPI_DELEGATION'
@@ -4486,14 +4488,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html](https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html)
    */
-  CONNECT_TO?: string[] | null
+  CONNECT_TO?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Connect to a specific host and port.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html](https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html)
    */
-  connectTo?: string[] | null
+  connectTo?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Timeout for the connection phase.
@@ -5378,14 +5380,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html)
    */
-  HTTP200ALIASES?: string[] | null
+  HTTP200ALIASES?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Alternative versions of 200 OK. See
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html)
    */
-  http200aliases?: string[] | null
+  http200aliases?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * HTTP server authentication methods.
@@ -5420,14 +5422,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html)
    */
-  HTTPHEADER?: string[] | null
+  HTTPHEADER?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Custom HTTP headers.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html)
    */
-  httpHeader?: string[] | null
+  httpHeader?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Deprecated option Multipart formpost HTTP POST.
@@ -5718,14 +5720,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html](https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html)
    */
-  MAIL_RCPT?: string[] | null
+  MAIL_RCPT?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Address of the recipients.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html](https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html)
    */
-  mailRcpt?: string[] | null
+  mailRcpt?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Allow RCPT TO command to fail for some recipients.
@@ -6082,14 +6084,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html)
    */
-  POSTFIELDS?: string | number | boolean | null
+  POSTFIELDS?: string | ArrayBuffer | ArrayBufferView | null
 
   /**
    * Send a POST with this data - does not copy it.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html)
    */
-  postFields?: string | number | boolean | null
+  postFields?: string | ArrayBuffer | ArrayBufferView | null
 
   /**
    * The POST data is this big.
@@ -6124,14 +6126,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html)
    */
-  POSTQUOTE?: string[] | null
+  POSTQUOTE?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Commands to run after transfer.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html)
    */
-  postQuote?: string[] | null
+  postQuote?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * How to act on redirects after POST.
@@ -6166,14 +6168,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html)
    */
-  PREQUOTE?: string[] | null
+  PREQUOTE?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Commands to run just before transfer.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html)
    */
-  preQuote?: string[] | null
+  preQuote?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Callback to be called after a connection is established but before a request is made on that connection.
@@ -6646,14 +6648,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html)
    */
-  PROXYHEADER?: string[] | null
+  PROXYHEADER?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Custom HTTP headers sent to proxy.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html)
    */
-  proxyHeader?: string[] | null
+  proxyHeader?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Proxy password.
@@ -6758,14 +6760,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html)
    */
-  QUOTE?: string[] | null
+  QUOTE?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Commands to run before transfer.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html)
    */
-  quote?: string[] | null
+  quote?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * OBSOLETE Provide source for entropy random data.
@@ -6888,14 +6890,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html](https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html)
    */
-  RESOLVE?: string[] | null
+  RESOLVE?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Provide fixed/fake name resolves.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html](https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html)
    */
-  resolve?: string[] | null
+  resolve?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * Resume a transfer.
@@ -7690,14 +7692,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html](https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html)
    */
-  TELNETOPTIONS?: string[] | null
+  TELNETOPTIONS?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * TELNET options.
    *
    * Official libcurl documentation: [https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html](https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html)
    */
-  telnetOptions?: string[] | null
+  telnetOptions?: string[] | HeaderList | [...string[], HeaderList] | null
 
   /**
    * TFTP block size.
@@ -10,8 +10,14 @@
  */
 import './moduleSetup'
 
-export { Curl } from './Curl'
-export { Easy, GetInfoReturn } from './Easy'
+export { Curl, MemoryUsage, TraceRecord, TraceSnapshot } from './Curl'
+export {
+  DebugLogEntry,
+  DebugLogOptions,
+  Easy,
+  GetInfoReturn,
+  ProgressThrottleOptions,
+} from './Easy'
 // import { Easy as EasyCls } from './Easy'
 // // @ts-expect-error
 // import type { Easy } from './types'
@@ -19,7 +25,33 @@ export { Easy, GetInfoReturn } from './Easy'
 // export const Easy = EasyCls
 
 export { Multi } from './Multi'
+export {
+  toChromeTrace,
+  type ChromeTrace,
+  type ChromeTraceEvent,
+  type ChromeTraceOptions,
+} from './ChromeTrace'
 export { Share } from './Share'
+export { HeaderList } from './HeaderList'
+export {
+  RangeDownloader,
+  RangeDownloadChangedError,
+  type RangeDownloaderOptions,
+  type RangeDownloadProbe,
+  type RangeDownloadResult,
+  type RangeDownloadSegment,
+} from './RangeDownloader'
+export {
+  DownloadManager,
+  type DownloadCheckpoint,
+  type DownloadManagerOptions,
+} from './DownloadManager'
+export {
+  MultipartUploader,
+  MultipartUploadError,
+  type MultipartUploaderOptions,
+  type MultipartUploadPart,
+} from './MultipartUploader'
 export { CurlMime } from './CurlMime'
 export { CurlMimePart, MimeDataCallbacks } from './CurlMimePart'
 export {
@@ -80,7 +112,11 @@ export * from './enum/CurlUseSsl'
 export * from './enum/CurlVersion'
 export * from './enum/CurlWriteFunc'
 export * from './enum/CurlWs'
+export * from './enum/ProgressCounter'
+export * from './enum/ReadBufferMode'
 export * from './enum/SocketState'
+export * from './enum/TraceEvent'
+export * from './enum/TransferPhase'
 
 // types that can be helpful for library consumer
 
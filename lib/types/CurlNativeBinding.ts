@@ -7,6 +7,7 @@
 import { CurlInfo } from '../generated/CurlInfo'
 import { CurlOption } from '../generated/CurlOption'
 import { MultiOption } from '../generated/MultiOption'
+import type { MemoryUsage } from '../Curl'
 
 /**
  * This is the internal `Curl` object exported by the addon. It's not available for library users directly.
@@ -17,6 +18,11 @@ export declare interface CurlNativeBindingObject {
   getVersion(): string
   VERSION_NUM: number
 
+  setTraceEnabled(enabled: boolean, capacity?: number): void
+  isTraceEnabled(): boolean
+  drainTrace(): { dropped: number; records: ArrayBuffer }
+  getMemoryUsage(): MemoryUsage
+
   info: CurlInfo
   option: CurlOption
   multi: MultiOption
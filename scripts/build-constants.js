@@ -68,6 +68,7 @@ const run = async () => {
       import { Easy } from "../Easy"
       import { Share } from "../Share"
       import { CurlMime } from "../CurlMime"
+      import { HeaderList } from "../HeaderList"
     `,
   })
 
@@ -39,6 +39,7 @@ const optionKindMap = {
     'HTTPPOST',
     'STREAM_DEPENDS',
     'STREAM_DEPENDS_E',
+    'POSTFIELDS',
     // enums
     'FTP_SSL_CCC',
     'FTP_FILEMETHOD',
@@ -70,7 +71,7 @@ const optionKindValueMap = {
     '((this: Easy, data: Buffer, size: number, nmemb: number) => number)',
   progressCallback:
     '((this: Easy, dltotal: number,dlnow: number,ultotal: number,ulnow: number) => number | CurlProgressFunc)',
-  stringList: 'string[]',
+  stringList: 'string[] | HeaderList | [...string[], HeaderList]',
   blob: 'ArrayBuffer | Buffer | string',
   /* @TODO Add type definitions, they are on Curl.chunk */
   CHUNK_BGN_FUNCTION:
@@ -100,6 +101,7 @@ const optionKindValueMap = {
   MIMEPOST: 'CurlMime',
   STREAM_DEPENDS: 'Easy',
   STREAM_DEPENDS_E: 'Easy',
+  POSTFIELDS: 'string | ArrayBuffer | ArrayBufferView',
 
   // enums
   FTP_SSL_CCC: 'CurlFtpSsl',
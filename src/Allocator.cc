@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "Allocator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#ifdef NODE_LIBCURL_ALLOCATOR_MIMALLOC
+#include <mimalloc.h>
+#endif
+
+#ifdef NODE_LIBCURL_ALLOCATOR_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+namespace NodeLibcurl::Allocator {
+
+namespace {
+
+void* SystemMalloc(size_t size) { return std::malloc(size); }
+void SystemFree(void* ptr) { std::free(ptr); }
+void* SystemRealloc(void* ptr, size_t size) { return std::realloc(ptr, size); }
+void* SystemCalloc(size_t count, size_t size) { return std::calloc(count, size); }
+
+char* SystemStrdup(const char* str) {
+  size_t size = std::strlen(str) + 1;
+
+  auto copy = static_cast<char*>(std::malloc(size));
+  if (copy) std::memcpy(copy, str, size);
+
+  return copy;
+}
+
+const Functions systemFunctions = {"system",      SystemMalloc, SystemFree,
+                                   SystemRealloc, SystemStrdup, SystemCalloc};
+
+#ifdef NODE_LIBCURL_ALLOCATOR_MIMALLOC
+void* MimallocMalloc(size_t size) { return mi_malloc(size); }
+void MimallocFree(void* ptr) { mi_free(ptr); }
+void* MimallocRealloc(void* ptr, size_t size) { return mi_realloc(ptr, size); }
+char* MimallocStrdup(const char* str) { return mi_strdup(str); }
+void* MimallocCalloc(size_t count, size_t size) { return mi_calloc(count, size); }
+
+const Functions mimallocFunctions = {"mimalloc",      MimallocMalloc, MimallocFree,
+                                     MimallocRealloc, MimallocStrdup, MimallocCalloc};
+#endif
+
+#ifdef NODE_LIBCURL_ALLOCATOR_JEMALLOC
+// flags selecting the arena created for libcurl, set before libcurl is initialized
+int jemallocFlags = 0;
+
+bool CreateJemallocArena() {
+  unsigned arena = 0;
+  size_t size = sizeof(arena);
+
+  if (mallctl("arenas.create", &arena, &size, nullptr, 0) != 0) {
+    return false;
+  }
+
+  jemallocFlags = MALLOCX_ARENA(arena);
+  return true;
+}
+
+// unlike malloc, the *allocx functions do not accept a size of 0
+void* JemallocMalloc(size_t size) { return mallocx(size ? size : 1, jemallocFlags); }
+
+void JemallocFree(void* ptr) {
+  if (ptr) dallocx(ptr, jemallocFlags);
+}
+
+void* JemallocRealloc(void* ptr, size_t size) {
+  if (!ptr) return JemallocMalloc(size);
+  return rallocx(ptr, size ? size : 1, jemallocFlags);
+}
+
+void* JemallocCalloc(size_t count, size_t size) {
+  if (size != 0 && count > std::numeric_limits<size_t>::max() / size) return nullptr;
+
+  size_t total = count * size;
+  return mallocx(total ? total : 1, jemallocFlags | MALLOCX_ZERO);
+}
+
+char* JemallocStrdup(const char* str) {
+  size_t size = std::strlen(str) + 1;
+
+  auto copy = static_cast<char*>(JemallocMalloc(size));
+  if (copy) std::memcpy(copy, str, size);
+
+  return copy;
+}
+
+const Functions jemallocFunctions = {"jemalloc",      JemallocMalloc, JemallocFree,
+                                     JemallocRealloc, JemallocStrdup, JemallocCalloc};
+#endif
+
+const Functions* BuildDefault() {
+#if defined(NODE_LIBCURL_ALLOCATOR_MIMALLOC)
+  return &mimallocFunctions;
+#elif defined(NODE_LIBCURL_ALLOCATOR_JEMALLOC)
+  return &jemallocFunctions;
+#else
+  return &systemFunctions;
+#endif
+}
+
+}  // namespace
+
+const Functions& System() { return systemFunctions; }
+
+const Functions* Selected(const char** error) {
+  static std::once_flag selectFlag;
+  static const Functions* selected = nullptr;
+  static const char* selectError = nullptr;
+
+  std::call_once(selectFlag, []() {
+    const char* name = std::getenv("NODE_LIBCURL_ALLOCATOR");
+
+    if (!name || !*name) {
+      selected = BuildDefault();
+    } else if (std::strcmp(name, "system") == 0) {
+      selected = &systemFunctions;
+#ifdef NODE_LIBCURL_ALLOCATOR_MIMALLOC
+    } else if (std::strcmp(name, "mimalloc") == 0) {
+      selected = &mimallocFunctions;
+#endif
+#ifdef NODE_LIBCURL_ALLOCATOR_JEMALLOC
+    } else if (std::strcmp(name, "jemalloc") == 0) {
+      selected = &jemallocFunctions;
+#endif
+    } else {
+      selectError =
+          "NODE_LIBCURL_ALLOCATOR must be system, or the allocator the addon was built with "
+          "(node_libcurl_allocator)";
+      return;
+    }
+
+#ifdef NODE_LIBCURL_ALLOCATOR_JEMALLOC
+    if (selected == &jemallocFunctions && !CreateJemallocArena()) {
+      selected = nullptr;
+      selectError = "Could not create the jemalloc arena for libcurl";
+    }
+#endif
+  });
+
+  if (error) *error = selectError;
+  return selected;
+}
+
+}  // namespace NodeLibcurl::Allocator
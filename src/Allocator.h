@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <curl/curl.h>
+
+// The allocator libcurl uses, given to it with curl_global_init_mem.
+//
+// Besides the system one, the addon can be built with mimalloc or jemalloc, with the
+// node_libcurl_allocator gyp variable, so that the many small allocations libcurl does for each
+// transfer do not compete with the rest of the process for the locks of the system malloc.
+// The jemalloc one uses an arena of its own, and mimalloc keeps its own heaps, separate from the
+// ones of malloc, unless the library itself was built to override malloc.
+//
+// The NODE_LIBCURL_ALLOCATOR environment variable selects one of the allocators built in, at
+// runtime, it defaults to the one selected at build time.
+namespace NodeLibcurl::Allocator {
+
+struct Functions {
+  const char* name;
+  curl_malloc_callback malloc;
+  curl_free_callback free;
+  curl_realloc_callback realloc;
+  curl_strdup_callback strdup;
+  curl_calloc_callback calloc;
+};
+
+// The allocator to be used for the process, decided on the first call.
+// Returns nullptr if NODE_LIBCURL_ALLOCATOR is not one of the allocators built in,
+// and sets error to the reason.
+const Functions* Selected(const char** error);
+
+// The system allocator, libcurl uses it when initialized with curl_global_init.
+const Functions& System();
+
+}  // namespace NodeLibcurl::Allocator
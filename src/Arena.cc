@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "Arena.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace NodeLibcurl {
+
+namespace {
+inline uintptr_t AlignUp(uintptr_t value, size_t alignment) {
+  return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+}  // namespace
+
+Arena::~Arena() {
+  this->RunFinalizers();
+  this->FreeBlocks();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  uintptr_t aligned = AlignUp(reinterpret_cast<uintptr_t>(this->cursor), alignment);
+  uintptr_t end = reinterpret_cast<uintptr_t>(this->end);
+
+  if (aligned > end || size > end - aligned) {
+    return this->AllocateSlow(size, alignment);
+  }
+
+  this->cursor = reinterpret_cast<char*>(aligned + size);
+  return reinterpret_cast<void*>(aligned);
+}
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+  // big allocations, like a large POSTFIELDS, get a block of their own,
+  // so the current block can still be used by the smaller ones.
+  bool isDedicated = size + alignment > kBlockSize;
+  size_t blockSize = isDedicated ? size + alignment : kBlockSize;
+
+  Block* block = static_cast<Block*>(std::malloc(sizeof(Block) + blockSize));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+
+  block->size = blockSize;
+  block->next = this->blocks;
+  this->blocks = block;
+
+  char* data = reinterpret_cast<char*>(block + 1);
+  uintptr_t aligned = AlignUp(reinterpret_cast<uintptr_t>(data), alignment);
+
+  if (!isDedicated) {
+    this->cursor = reinterpret_cast<char*>(aligned + size);
+    this->end = data + blockSize;
+  }
+
+  return reinterpret_cast<void*>(aligned);
+}
+
+char* Arena::CopyString(const char* data, size_t length) {
+  char* copy = static_cast<char*>(this->Allocate(length + 1, 1));
+  std::memcpy(copy, data, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+char* Arena::CopyString(const Napi::Value& value) {
+  Napi::Env env = value.Env();
+
+  size_t length = 0;
+  napi_status status = napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+  if (status != napi_ok) {
+    throw Napi::Error::New(env);
+  }
+
+  char* data = static_cast<char*>(this->Allocate(length + 1, 1));
+  status = napi_get_value_string_utf8(env, value, data, length + 1, &length);
+  if (status != napi_ok) {
+    throw Napi::Error::New(env);
+  }
+
+  return data;
+}
+
+curl_slist* Arena::NewSlistNode(char* data) {
+  curl_slist* node =
+      static_cast<curl_slist*>(this->Allocate(sizeof(curl_slist), alignof(curl_slist)));
+  node->data = data;
+  node->next = nullptr;
+  return node;
+}
+
+void Arena::Defer(void (*finalizer)(void*), void* ptr) {
+  Finalizer* node =
+      static_cast<Finalizer*>(this->Allocate(sizeof(Finalizer), alignof(Finalizer)));
+  node->fn = finalizer;
+  node->ptr = ptr;
+  node->next = this->finalizers;
+  this->finalizers = node;
+}
+
+void Arena::Reset() {
+  this->RunFinalizers();
+  this->FreeBlocks();
+
+  this->cursor = this->inlineData;
+  this->end = this->inlineData + kInlineSize;
+}
+
+void Arena::RunFinalizers() {
+  // the nodes themselves live in the arena, so there is nothing to free here
+  for (Finalizer* node = this->finalizers; node; node = node->next) {
+    node->fn(node->ptr);
+  }
+  this->finalizers = nullptr;
+}
+
+void Arena::FreeBlocks() {
+  Block* block = this->blocks;
+  while (block) {
+    Block* next = block->next;
+    std::free(block);
+    block = next;
+  }
+  this->blocks = nullptr;
+}
+
+}  // namespace NodeLibcurl
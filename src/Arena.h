@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <curl/curl.h>
+#include <napi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace NodeLibcurl {
+
+// Bump allocator owning everything an Easy handle must keep alive while an option is set:
+// strings libcurl does not copy (like POSTFIELDS), the curl_slist nodes of the linked list
+// options, and objects that need to be finalized, like CurlHttpPost and curl_mime.
+//
+// Nothing is freed individually. Memory is released all at once when the arena is reset or
+// destroyed, and the first block lives inline, so the usual handful of headers and a small body
+// need no allocation besides the arena itself, and resetting it is just moving a pointer back.
+class Arena {
+ public:
+  Arena() = default;
+  ~Arena();
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Copies length bytes from data, adding a null terminator at the end.
+  char* CopyString(const char* data, size_t length);
+
+  // Copies the utf-8 contents of a JS string, without going through a temporary std::string.
+  char* CopyString(const Napi::Value& value);
+
+  // libcurl never modifies nor frees the lists given to the slist options,
+  // so their nodes can be allocated here, instead of using curl_slist_append.
+  curl_slist* NewSlistNode(char* data);
+
+  // Registers a function that is called with ptr when the arena is reset or destroyed.
+  // They are called in the reverse order they were registered.
+  void Defer(void (*finalizer)(void*), void* ptr);
+
+  template <typename T>
+  T* Adopt(std::unique_ptr<T> ptr) {
+    T* raw = ptr.release();
+    this->Defer([](void* p) { delete static_cast<T*>(p); }, raw);
+    return raw;
+  }
+
+  // Constructs a T inside the arena, its destructor is called when the arena is reset.
+  template <typename T, typename... Args>
+  T* Make(Args&&... args) {
+    void* memory = this->Allocate(sizeof(T), alignof(T));
+    T* object = new (memory) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      this->Defer([](void* p) { static_cast<T*>(p)->~T(); }, object);
+    }
+    return object;
+  }
+
+  // Runs the finalizers and releases every block but the inline one.
+  void Reset();
+
+ private:
+  struct Block {
+    Block* next;
+    size_t size;
+  };
+
+  struct Finalizer {
+    void (*fn)(void*);
+    void* ptr;
+    Finalizer* next;
+  };
+
+  static constexpr size_t kInlineSize = 1024;
+  static constexpr size_t kBlockSize = 4096;
+
+  void* AllocateSlow(size_t size, size_t alignment);
+  void RunFinalizers();
+  void FreeBlocks();
+
+  alignas(std::max_align_t) char inlineData[kInlineSize];
+  char* cursor = inlineData;
+  char* end = inlineData + kInlineSize;
+
+  // blocks allocated after the inline one was filled, newest first
+  Block* blocks = nullptr;
+  Finalizer* finalizers = nullptr;
+
+  Arena(const Arena& that) = delete;
+  Arena& operator=(const Arena& that) = delete;
+};
+
+}  // namespace NodeLibcurl
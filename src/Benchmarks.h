@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <napi.h>
+
+// Microbenchmarks of the native hot paths, using Google Benchmark.
+//
+// Only built when the node_libcurl_benchmarks gyp variable is set, which compiles the sources in
+// benchmark/native into the addon and adds Curl.runBenchmarks to the binding, see
+// benchmark/native/README.md. They run inside Node.js, on the main thread, as most of the paths
+// measured need a napi_env or the event loop of one.
+namespace NodeLibcurl::Benchmarks {
+
+// Reach the private members of Multi and Easy the benchmarks need.
+class MultiAccess;
+class EasyAccess;
+
+// runBenchmarks(args: string[], options: { multi?: Multi, easy?: Easy, file?: string }): void
+// args are the Google Benchmark command line flags, like --benchmark_filter.
+// The Multi handle is used by the socket context benchmarks, the Easy handle by the borrowed
+// and pooled Buffer strategies, and the file by the ones transferring it with file://, each
+// group is skipped if not given.
+Napi::Value Run(const Napi::CallbackInfo& info);
+
+}  // namespace NodeLibcurl::Benchmarks
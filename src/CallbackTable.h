@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <napi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace NodeLibcurl {
+
+// The JS callbacks an Easy handle can have, one for each *FUNCTION option.
+// The values are recorded in the trace, keep in sync with TraceCallback in lib/enum/TraceEvent.ts
+enum class CallbackSlot : uint8_t {
+  ChunkBgn,
+  ChunkEnd,
+  Debug,
+  FnMatch,
+  Header,
+  HstsRead,
+  HstsWrite,
+  Interleave,
+  PreReq,
+  Progress,
+  Read,
+  Seek,
+  SshHostKey,
+  Trailer,
+  Write,
+  Xferinfo,
+  Count
+};
+
+// Fixed table of the JS callbacks of an Easy handle, indexed by CallbackSlot.
+//
+// The libcurl trampolines run for every chunk of every transfer, so checking if a callback is
+// set is a single bit test, instead of a lookup in a map keyed by the option.
+// Only the slots in the mask hold a reference, so copying and clearing the table
+// only touches the callbacks that are actually set.
+class CallbackTable {
+ public:
+  bool Has(CallbackSlot slot) const noexcept { return (this->mask & Bit(slot)) != 0; }
+
+  // The slot must be set, check it with Has first.
+  Napi::Function Get(CallbackSlot slot) const { return this->slots[Index(slot)].Value(); }
+
+  void Set(CallbackSlot slot, Napi::Function callback) {
+    this->slots[Index(slot)] = Napi::Persistent(callback);
+    this->mask |= Bit(slot);
+  }
+
+  void Reset(CallbackSlot slot) {
+    if (!this->Has(slot)) return;
+
+    this->slots[Index(slot)].Reset();
+    this->mask &= ~Bit(slot);
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < kSize; ++i) {
+      if (this->mask & (1u << i)) this->slots[i].Reset();
+    }
+    this->mask = 0;
+  }
+
+  // Adds a new reference to each callback set in other.
+  void CopyFrom(const CallbackTable& other) {
+    for (size_t i = 0; i < kSize; ++i) {
+      if (other.mask & (1u << i)) {
+        this->Set(static_cast<CallbackSlot>(i), other.slots[i].Value());
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kSize = static_cast<size_t>(CallbackSlot::Count);
+  static_assert(kSize <= 32, "The mask of CallbackTable has room for 32 slots");
+
+  static constexpr size_t Index(CallbackSlot slot) { return static_cast<size_t>(slot); }
+  static constexpr uint32_t Bit(CallbackSlot slot) { return 1u << Index(slot); }
+
+  std::array<Napi::FunctionReference, kSize> slots;
+  uint32_t mask = 0;
+};
+
+}  // namespace NodeLibcurl
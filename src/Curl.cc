@@ -11,14 +11,21 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include "Allocator.h"
+#ifdef NODE_LIBCURL_BENCHMARKS
+#include "Benchmarks.h"
+#endif
 #include "Curl.h"
 #include "CurlError.h"
 #include "CurlHttpPost.h"
 #include "CurlMime.h"
 #include "CurlVersionInfo.h"
 #include "Easy.h"
+#include "HeaderList.h"
 #include "Http2PushFrameHeaders.h"
+#include "MemoryTracker.h"
 #include "Share.h"
+#include "Trace.h"
 #include "curl/curl.h"
 #include "macros.h"
 
@@ -841,6 +848,7 @@ Curl::Curl(Napi::Env env, Napi::Object exports) : env(env), addonAllocatedMemory
   this->ShareConstructor = Napi::Persistent(Share::Init(env, exports));
   this->Http2PushFrameHeadersConstructor =
       Napi::Persistent(Http2PushFrameHeaders::Init(env, exports));
+  this->HeaderListConstructor = Napi::Persistent(HeaderList::Init(env, exports));
 #if NODE_LIBCURL_VER_GE(7, 56, 0)
   this->CurlMimeConstructor = Napi::Persistent(CurlMime::Init(env, exports));
   this->CurlMimePartConstructor = Napi::Persistent(CurlMimePart::Init(env, exports));
@@ -901,18 +909,35 @@ void Curl::InitTLS() {
 }
 
 void Curl::AdjustHandleMemory(CurlHandleType handleType, int delta) {
+  this->activeHandleCount[handleType] += delta;
+
+  // the real usage is reported instead
+  if (MemoryTracker::IsEnabled()) {
+    this->SyncTrackedMemory();
+    return;
+  }
+
   auto size = handleMemoryMap[handleType];
   auto usage = size * delta;
   this->addonAllocatedMemory += usage;
   Napi::MemoryManagement::AdjustExternalMemory(this->env, usage);
 
-  this->activeHandleCount[handleType] += delta;
-
   // we used to have checks against v8 not running, as this was based on libxml:
   // https://github.com/libxmljs/libxmljs/blob/master/src/libxmljs.cc
   // We do not have that anymore.
 }
 
+void Curl::SyncTrackedMemory() {
+  if (!MemoryTracker::IsEnabled()) return;
+
+  // the environment runs on this thread, so the memory counted on it is what it holds
+  int64_t delta = MemoryTracker::ThreadTotal() - this->addonAllocatedMemory;
+  if (delta > -kTrackedMemorySyncThreshold && delta < kTrackedMemorySyncThreshold) return;
+
+  this->addonAllocatedMemory += delta;
+  Napi::MemoryManagement::AdjustExternalMemory(this->env, delta);
+}
+
 void Curl::CleanupData(Napi::Env env, Curl* data) {
   delete data;
   curl_global_cleanup();
@@ -920,14 +945,14 @@ void Curl::CleanupData(Napi::Env env, Curl* data) {
 
 // Initialize function
 Napi::Object Curl::Init(Napi::Env env, Napi::Object exports) {
-  // We used to use curl_global_init_mem, as we would use it to adjust memory usage of the addon
-  // however when running with multiple environments, this would not make a lot of sense, as we
-  // would be unable to track which environment is responsible for the memory usage.
-  CURLcode code = curl_global_init(static_cast<long>(CURL_GLOBAL_ALL));
+  // curl_global_init_mem is only used when NODE_LIBCURL_TRACK_MEMORY is set, the allocations are
+  // counted per thread, so each environment is only accountable for the memory allocated on it.
+  const char* initError = nullptr;
+  CURLcode code = MemoryTracker::GlobalInit(static_cast<long>(CURL_GLOBAL_ALL), &initError);
 
   if (code != CURLE_OK) {
-    throw Napi::Error::New(
-        env, "Failed to initialize libcurl: " + std::string(curl_easy_strerror(code)));
+    throw Napi::Error::New(env, "Failed to initialize libcurl: " +
+                                    std::string(initError ? initError : curl_easy_strerror(code)));
   }
 
   Curl* curl = new Curl(env, exports);
@@ -955,7 +980,25 @@ Napi::Object Curl::Init(Napi::Env env, Napi::Object exports) {
       "THREAD_ID", Curl::GetThreadId,
       static_cast<napi_property_attributes>(napi_enumerable | napi_configurable));
 
-  curlJs.DefineProperties({getVersion, getCount, versionNum, threadId});
+  auto setTraceEnabled = Napi::PropertyDescriptor::Function(
+      "setTraceEnabled", Trace::SetEnabled, static_cast<napi_property_attributes>(napi_enumerable));
+
+  auto isTraceEnabled = Napi::PropertyDescriptor::Function(
+      "isTraceEnabled", Trace::GetEnabled, static_cast<napi_property_attributes>(napi_enumerable));
+
+  auto drainTrace = Napi::PropertyDescriptor::Function(
+      "drainTrace", Trace::Drain, static_cast<napi_property_attributes>(napi_enumerable));
+
+  auto getMemoryUsage = Napi::PropertyDescriptor::Function(
+      "getMemoryUsage", Curl::GetMemoryUsage,
+      static_cast<napi_property_attributes>(napi_enumerable));
+
+  curlJs.DefineProperties({getVersion, getCount, versionNum, threadId, setTraceEnabled,
+                           isTraceEnabled, drainTrace, getMemoryUsage});
+
+#ifdef NODE_LIBCURL_BENCHMARKS
+  curlJs.Set("runBenchmarks", Napi::Function::New(env, Benchmarks::Run, "runBenchmarks"));
+#endif
 
   // Create option object
   Napi::Object curlOption = Napi::Object::New(env);
@@ -1017,6 +1060,35 @@ Napi::Value Curl::GetCount(const Napi::CallbackInfo& info) {
   return Napi::Number::New(env, curl->activeHandleCount[CURL_HANDLE_TYPE_EASY]);
 }
 
+Napi::Value Curl::GetMemoryUsage(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  auto curl = env.GetInstanceData<Curl>();
+
+  curl->SyncTrackedMemory();
+
+  using MemoryTracker::Category;
+  auto bytes = [&](Category category) {
+    return Napi::Number::New(env, static_cast<double>(MemoryTracker::ThreadBytes(category)));
+  };
+
+  Napi::Object categories = Napi::Object::New(env);
+  categories.Set("handles", bytes(Category::Handles));
+  categories.Set("options", bytes(Category::Options));
+  categories.Set("transfers", bytes(Category::Transfers));
+  categories.Set("other", bytes(Category::Other));
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("tracked", Napi::Boolean::New(env, MemoryTracker::IsEnabled()));
+  result.Set("allocator", Napi::String::New(env, Allocator::Selected(nullptr)->name));
+  result.Set("total",
+             Napi::Number::New(env, static_cast<double>(MemoryTracker::ThreadTotal())));
+  result.Set("reported",
+             Napi::Number::New(env, static_cast<double>(curl->addonAllocatedMemory)));
+  result.Set("categories", categories);
+
+  return result;
+}
+
 Napi::Value Curl::GetVersionNum(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   return Napi::Number::New(env, LIBCURL_VERSION_NUM);
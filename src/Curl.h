@@ -91,12 +91,15 @@ class Curl {
   Napi::FunctionReference CurlSharedErrorConstructor;
   Napi::FunctionReference CurlMimeConstructor;
   Napi::FunctionReference CurlMimePartConstructor;
+  Napi::FunctionReference HeaderListConstructor;
   Napi::Env env;
 
   std::string caCertificatesData;
   struct curl_blob caCertificatesBlob;
 
   void AdjustHandleMemory(CurlHandleType handleType, int delta);
+  // Reports to V8 the change in the memory libcurl holds for this environment, when it is tracked
+  void SyncTrackedMemory();
 
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
   static void CleanupData(Napi::Env env, Curl* data);
@@ -105,9 +108,14 @@ class Curl {
   static Napi::Value GetCount(const Napi::CallbackInfo& info);
   static Napi::Value GetVersionNum(const Napi::CallbackInfo& info);
   static Napi::Value GetThreadId(const Napi::CallbackInfo& info);
+  static Napi::Value GetMemoryUsage(const Napi::CallbackInfo& info);
 
  private:
+  // memory reported to V8 with AdjustExternalMemory
   int64_t addonAllocatedMemory;
+
+  // smaller changes of the tracked memory are not reported right away
+  static constexpr int64_t kTrackedMemorySyncThreshold = 64 * 1024;
   std::unordered_map<CurlHandleType, int> activeHandleCount = {
       {CURL_HANDLE_TYPE_EASY, 0}, {CURL_HANDLE_TYPE_MULTI, 0}, {CURL_HANDLE_TYPE_SHARE, 0}};
 
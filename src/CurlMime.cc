@@ -79,7 +79,7 @@ CurlMime::CurlMime(const Napi::CallbackInfo& info)
 
 CurlMime::~CurlMime() {
   // Note: Do not free mime here!
-  // The mime handle is managed by Easy::ToFree and will be freed
+  // The mime handle is managed by the Easy handle arena and will be freed
   // when the Easy handle is disposed or when MIMEPOST is reset.
   // This allows the MIME structure to persist after the JS object is GC'd.
 }
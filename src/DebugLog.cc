@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "DebugLog.h"
+
+#include <uv.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace NodeLibcurl {
+
+DebugLog::DebugLog(uint32_t capacity, uint32_t maxDataSize, uint32_t typeMask)
+    : capacity(capacity),
+      maxDataSize(maxDataSize),
+      typeMask(typeMask),
+      entries(new Entry[capacity]),
+      data(new char[static_cast<size_t>(capacity) * maxDataSize]) {}
+
+void DebugLog::Record(curl_infotype type, const char* data, size_t size) {
+  Entry& entry = this->entries[this->head];
+
+  entry.timestamp = uv_hrtime();
+  entry.type = type;
+  entry.size = size;
+  entry.storedSize = static_cast<uint32_t>(std::min<size_t>(size, this->maxDataSize));
+
+  if (entry.storedSize > 0) {
+    std::memcpy(this->data.get() + static_cast<size_t>(this->head) * this->maxDataSize, data,
+                entry.storedSize);
+  }
+
+  this->head = (this->head + 1) % this->capacity;
+
+  if (this->count == this->capacity) {
+    ++this->dropped;
+  } else {
+    ++this->count;
+  }
+}
+
+Napi::Array DebugLog::Drain(Napi::Env env, uint64_t handleId) {
+  Napi::Array result = Napi::Array::New(env, this->count);
+
+  uint32_t index = (this->head + this->capacity - this->count) % this->capacity;
+
+  for (uint32_t i = 0; i < this->count; ++i) {
+    const Entry& entry = this->entries[index];
+    const char* entryData = this->data.get() + static_cast<size_t>(index) * this->maxDataSize;
+
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("timestamp", Napi::BigInt::New(env, entry.timestamp));
+    item.Set("handleId", Napi::Number::New(env, static_cast<double>(handleId)));
+    item.Set("type", Napi::Number::New(env, static_cast<int32_t>(entry.type)));
+    item.Set("data", Napi::Buffer<char>::Copy(env, entryData, entry.storedSize));
+    item.Set("size", Napi::Number::New(env, static_cast<double>(entry.size)));
+
+    result.Set(i, item);
+
+    index = (index + 1) % this->capacity;
+  }
+
+  this->count = 0;
+  this->dropped = 0;
+
+  return result;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <curl/curl.h>
+#include <napi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace NodeLibcurl {
+
+// Fixed size ring of the debug output of libcurl (what VERBOSE prints), recorded natively by the
+// DEBUGFUNCTION, so it can be kept enabled without calling into JS for every line.
+//
+// All the memory is allocated upfront, capacity entries of at most maxDataSize bytes each,
+// data larger than that is truncated. Once full, new entries overwrite the oldest ones.
+// It is only used from the thread of the Easy handle owning it, so it needs no synchronization.
+class DebugLog {
+ public:
+  DebugLog(uint32_t capacity, uint32_t maxDataSize, uint32_t typeMask);
+
+  bool Accepts(curl_infotype type) const noexcept {
+    return type < 32 && (this->typeMask & (1u << type)) != 0;
+  }
+
+  void Record(curl_infotype type, const char* data, size_t size);
+
+  // Returns the entries recorded since the last call, from oldest to newest,
+  // as an array of { timestamp, handleId, type, data, size } objects, and empties the ring.
+  Napi::Array Drain(Napi::Env env, uint64_t handleId);
+
+  // Entries overwritten before they were drained, since the last call to Drain.
+  uint64_t Dropped() const noexcept { return this->dropped; }
+
+ private:
+  struct Entry {
+    uint64_t timestamp;
+    size_t size;
+    uint32_t storedSize;
+    curl_infotype type;
+  };
+
+  uint32_t capacity;
+  uint32_t maxDataSize;
+  uint32_t typeMask;
+
+  std::unique_ptr<Entry[]> entries;
+  std::unique_ptr<char[]> data;
+
+  // next entry to be written, and how many of the entries before it were not drained yet
+  uint32_t head = 0;
+  uint32_t count = 0;
+  uint64_t dropped = 0;
+};
+
+}  // namespace NodeLibcurl
@@ -18,13 +18,20 @@
 #include "CurlHttpPost.h"
 #include "CurlMime.h"
 #include "Easy.h"
+#include "HeaderList.h"
 #include "LocaleGuard.h"
+#include "MemoryTracker.h"
+#include "Multi.h"
+#include "Probes.h"
 #include "Share.h"
+#include "Trace.h"
 #include "macros.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 // 36055 was allocated on Win64
 #define MEMORY_PER_HANDLE 30000
@@ -34,35 +41,45 @@
 namespace NodeLibcurl {
 
 // Static member initialization
-std::atomic<uint64_t> Easy::nextId = 0;
+// 0 is left for trace records that are not from a handle, see Trace::Record
+std::atomic<uint64_t> Easy::nextId = 1;
 
 const napi_type_tag EASY_TYPE_TAG = {
     // this is basically a
     0xf641cc92779c4526, 0xaca73000a471ece6};
 
-// ToFree class for memory management
-class Easy::ToFree {
- public:
-  std::vector<std::vector<char>> str;
-  std::vector<curl_slist*> slist;
-  std::vector<curl_mime*> mime;
-  std::vector<std::unique_ptr<CurlHttpPost>> post;
+// Retrieves the memory backing a Buffer, ArrayBuffer or any other ArrayBufferView.
+static bool GetBinaryData(const Napi::Value& value, char** data, size_t* length) {
+  if (value.IsArrayBuffer()) {
+    auto arrayBuffer = value.As<Napi::ArrayBuffer>();
+    *data = static_cast<char*>(arrayBuffer.Data());
+    *length = arrayBuffer.ByteLength();
+    return true;
+  }
 
-  ~ToFree() {
-    for (auto& list : slist) {
-      if (list) curl_slist_free_all(list);
-    }
-    for (auto& m : mime) {
-      if (m) curl_mime_free(m);
-    }
+  if (value.IsTypedArray()) {
+    auto typedArray = value.As<Napi::TypedArray>();
+    *data = static_cast<char*>(typedArray.ArrayBuffer().Data()) + typedArray.ByteOffset();
+    *length = typedArray.ByteLength();
+    return true;
+  }
+
+  if (value.IsDataView()) {
+    auto dataView = value.As<Napi::DataView>();
+    *data = static_cast<char*>(dataView.Data());
+    *length = dataView.ByteLength();
+    return true;
   }
-};
+
+  return false;
+}
 
 // Constructor
 Easy::Easy(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<Easy>(info), id(nextId++), toFree(std::make_shared<ToFree>()) {
+    : Napi::ObjectWrap<Easy>(info), id(nextId++), arena(std::make_shared<Arena>()) {
   NODE_LIBCURL_DEBUG_LOG(this, "Easy::Constructor", "");
   Napi::Env env = info.Env();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
 
   Curl* curl = env.GetInstanceData<Curl>();
 
@@ -144,6 +161,13 @@ void Easy::Dispose() {
   assert(this->isOpen && "This handle was already closed.");
   assert(this->ch && "The curl handle ran away.");
 
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
+
+  // only possible when garbage collected, as closing it throws while it is inside a Multi
+  if (this->multi) {
+    this->multi->DetachHandle(this);
+  }
+
   curl_easy_cleanup(this->ch);
   this->ch = nullptr;
   this->isOpen = false;
@@ -160,19 +184,36 @@ void Easy::Dispose() {
 
 // This does not dispose the handle, just the internal data, keeping the handle alive.
 void Easy::DisposeInternalData() {
-  this->callbacks.clear();
+  this->callbacks.Clear();
   this->hstsReadCache.clear();
+  this->pinnedBuffers.clear();
 
   this->cbOnSocketEvent.Reset();
   this->callbackError.Reset();
 
   // not clear! This is shared with other handles, so we cannot clear it.
   this->cbOnSocketEventAsyncContext.reset();
-  this->toFree.reset();
+  this->transferAsyncContext.reset();
+  this->arena.reset();
+
+  this->debugLog.reset();
+  this->isVerboseSetByUser = false;
 
   this->isCbProgressAlreadyAborted = false;
+  this->isCancelled = false;
+  this->isPostFieldsSizeFromBuffer = false;
   this->readDataFileDescriptor = -1;
   this->readDataOffset = -1;
+  this->uploadSource.reset();
+  this->fileReadAhead.reset();
+  this->writeDataFileDescriptor = -1;
+  this->writeDataOffset = 0;
+  this->writeDataBytesWritten = 0;
+  this->readBufferMode = ReadBufferMode::Copy;
+  this->readBufferPool.Reset();
+  this->progressThrottle = ProgressThrottle();
+  this->progressCountersArray.Reset();
+  this->progressCounters = nullptr;
 }
 
 void Easy::ResetRequiredHandleOptions(bool isFromDuplicate) {
@@ -229,11 +270,7 @@ void Easy::ResetRequiredHandleOptions(bool isFromDuplicate) {
 
 void Easy::CopyOtherData(Easy* orig) {
   // Copy the orig callbacks to the current handle
-  for (auto& [option, callback] : orig->callbacks) {
-    if (!callback.IsEmpty()) {
-      this->callbacks[option] = Napi::Persistent(callback.Value());
-    }
-  }
+  this->callbacks.CopyFrom(orig->callbacks);
 
   if (!orig->cbOnSocketEvent.IsEmpty()) {
     this->cbOnSocketEvent = Napi::Persistent(orig->cbOnSocketEvent.Value());
@@ -241,8 +278,26 @@ void Easy::CopyOtherData(Easy* orig) {
     this->cbOnSocketEventAsyncContext = orig->cbOnSocketEventAsyncContext;
   }
 
-  // Copy shared ToFree data
-  this->toFree = orig->toFree;
+  // libcurl duplicates the pointers to the data stored in the arena, so it must be shared
+  this->arena = orig->arena;
+
+  // same for the buffers being used directly
+  this->isZeroCopyEnabled = orig->isZeroCopyEnabled;
+  this->isPostFieldsSizeFromBuffer = orig->isPostFieldsSizeFromBuffer;
+  for (auto& [option, buffer] : orig->pinnedBuffers) {
+    this->pinnedBuffers[option] = Napi::Persistent(buffer.Value());
+  }
+
+  if (orig->uploadSource) {
+    this->uploadSource = orig->uploadSource->Clone();
+  }
+
+  this->readBufferMode = orig->readBufferMode;
+  this->isVerboseSetByUser = orig->isVerboseSetByUser;
+
+  this->progressThrottle.intervalNs = orig->progressThrottle.intervalNs;
+  this->progressThrottle.minBytes = orig->progressThrottle.minBytes;
+  this->progressThrottle.minPercentage = orig->progressThrottle.minPercentage;
 }
 
 void Easy::CallSocketEvent(int status, int events) {
@@ -361,6 +416,16 @@ Napi::Function Easy::Init(Napi::Env env, Napi::Object exports) {
        InstanceMethod("onSocketEvent", &Easy::OnSocketEvent),
        InstanceMethod("monitorSocketEvents", &Easy::MonitorSocketEvents),
        InstanceMethod("unmonitorSocketEvents", &Easy::UnmonitorSocketEvents),
+       InstanceMethod("setZeroCopy", &Easy::SetZeroCopy),
+       InstanceMethod("setUploadBuffers", &Easy::SetUploadBuffers),
+       InstanceMethod("setUploadFile", &Easy::SetUploadFile),
+       InstanceMethod("setDownloadFile", &Easy::SetDownloadFile),
+       InstanceMethod("setReadBufferMode", &Easy::SetReadBufferMode),
+       InstanceMethod("setProgressThrottle", &Easy::SetProgressThrottle),
+       InstanceMethod("setProgressCounters", &Easy::SetProgressCounters),
+       InstanceMethod("setDebugLog", &Easy::SetDebugLog),
+       InstanceMethod("drainDebugLog", &Easy::DrainDebugLog),
+       InstanceMethod("cancel", &Easy::Cancel),
        InstanceMethod("close", &Easy::Close),
 
        // Static methods
@@ -373,7 +438,9 @@ Napi::Function Easy::Init(Napi::Env env, Napi::Object exports) {
        InstanceAccessor("pauseFlags", &Easy::GetterPauseFlags, nullptr),
        InstanceAccessor("isPausedSend", &Easy::GetterIsPausedSend, nullptr),
        InstanceAccessor("isPausedRecv", &Easy::GetterIsPausedRecv, nullptr),
-       InstanceAccessor("isOpen", &Easy::GetterIsOpen, nullptr)});
+       InstanceAccessor("isOpen", &Easy::GetterIsOpen, nullptr),
+       InstanceAccessor("downloadFileBytesWritten", &Easy::GetterDownloadFileBytesWritten,
+                        nullptr)});
 
   exports.Set("Easy", func);
   return func;
@@ -408,6 +475,10 @@ Napi::Value Easy::GetterIsPausedSend(const Napi::CallbackInfo& info) {
   return Napi::Boolean::New(info.Env(), (this->pauseState & CURLPAUSE_SEND) != 0);
 }
 
+Napi::Value Easy::GetterDownloadFileBytesWritten(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(this->writeDataBytesWritten));
+}
+
 Napi::Value Easy::DebugLog(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
@@ -425,6 +496,7 @@ Napi::Value Easy::DebugLog(const Napi::CallbackInfo& info) {
 Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   auto curl = env.GetInstanceData<Curl>();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Options);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
@@ -444,6 +516,8 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
   // See this: https://daniel.haxx.se/blog/2020/08/28/enabling-better-curl-bindings/
   // we probably could use these here for newer libcurl versions...
 
+  // the order of the lookups is also measured by BM_SetOptLookupChain, in
+  // benchmark/native/Benchmarks.cc, keep its setOptChain in sync.
   if ((optionId = IsInsideCurlConstantStruct(curlOptionNotImplemented, opt))) {
     throw CurlError::New(env,
                          "Unsupported option, probably because it's too complex to implement "
@@ -597,7 +671,7 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
 
       setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_HTTPPOST, httpPost->first);
       if (setOptRetCode == CURLE_OK) {
-        this->toFree->post.push_back(std::move(httpPost));
+        this->arena->Adopt(std::move(httpPost));
       }
 
 #if NODE_LIBCURL_VER_GE(7, 56, 0)
@@ -634,56 +708,114 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_MIMEPOST, curlMime->mime);
 
       if (setOptRetCode == CURLE_OK) {
-        this->toFree->mime.push_back(curlMime->mime);
+        this->arena->Defer([](void* mime) { curl_mime_free(static_cast<curl_mime*>(mime)); },
+                           curlMime->mime);
       }
 #endif
 
     } else {
-      if (!value.IsArray()) {
-        throw Napi::TypeError::New(env, "Option value must be an Array.");
-      }
+      auto headerListConstructor = curl->HeaderListConstructor.Value();
+      auto isHeaderList = [&headerListConstructor](const Napi::Value& item) {
+        return item.IsObject() && item.As<Napi::Object>().InstanceOf(headerListConstructor);
+      };
 
-      // convert value to curl linked list (curl_slist)
+      // convert value to curl linked list (curl_slist), the nodes and their data
+      // are allocated in the arena, and released when the handle is reset or closed.
       curl_slist* slist = NULL;
-      Napi::Array array = value.As<Napi::Array>();
+      curl_slist** next = &slist;
+      std::shared_ptr<const HeaderList::Storage> headerList;
 
-      for (uint32_t i = 0, len = array.Length(); i < len; ++i) {
-        std::string item = array.Get(i).As<Napi::String>().Utf8Value();
-        slist = curl_slist_append(slist, item.c_str());
-      }
+      if (isHeaderList(value)) {
+        headerList = HeaderList::Unwrap(value.As<Napi::Object>())->storage;
+      } else {
+        if (!value.IsArray()) {
+          throw Napi::TypeError::New(env, "Option value must be an Array or a HeaderList.");
+        }
 
-      setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), slist);
+        Napi::Array array = value.As<Napi::Array>();
 
-      if (setOptRetCode == CURLE_OK) {
-        this->toFree->slist.push_back(slist);
+        for (uint32_t i = 0, len = array.Length(); i < len; ++i) {
+          Napi::Value item = array.Get(i);
+
+          if (!item.IsString() && isHeaderList(item)) {
+            if (i != len - 1) {
+              throw Napi::TypeError::New(
+                  env, "A HeaderList can only be used as the last item of the Array.");
+            }
+
+            headerList = HeaderList::Unwrap(item.As<Napi::Object>())->storage;
+            break;
+          }
+
+          *next = this->arena->NewSlistNode(this->arena->CopyString(item));
+          next = &(*next)->next;
+        }
       }
+
+      // the shared list is never modified, the items given before it are linked in
+      // front of its first node, and it is kept alive for as long as our arena is.
+      if (headerList) {
+        *next = headerList->first;
+        this->arena->Make<std::shared_ptr<const HeaderList::Storage>>(std::move(headerList));
+      }
+
+      setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), slist);
     }
 
     // check if option is string, and the value is correct
   } else if ((optionId = IsInsideCurlConstantStruct(curlOptionString, opt))) {
+    bool isPostFields = static_cast<CURLoption>(optionId) == CURLOPT_POSTFIELDS;
+    char* binaryData = nullptr;
+    size_t binaryLength = 0;
+
+    if (isPostFields) {
+      // whatever was kept alive for the previous value is not needed anymore
+      this->pinnedBuffers.erase(CURLOPT_POSTFIELDS);
+
+      if (this->isPostFieldsSizeFromBuffer) {
+        curl_easy_setopt(this->ch, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(-1));
+        this->isPostFieldsSizeFromBuffer = false;
+      }
+    }
+
     if (value.IsNull()) {
       setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), NULL);
+    } else if (isPostFields && GetBinaryData(value, &binaryData, &binaryLength)) {
+      // binary data can contain null bytes, so we need to tell libcurl its size.
+      if (!this->isZeroCopyEnabled) {
+        char* copy = static_cast<char*>(this->arena->Allocate(binaryLength, 1));
+        if (binaryLength > 0) {
+          std::memcpy(copy, binaryData, binaryLength);
+        }
+        binaryData = copy;
+      }
+
+      curl_easy_setopt(this->ch, CURLOPT_POSTFIELDSIZE_LARGE,
+                       static_cast<curl_off_t>(binaryLength));
+      this->isPostFieldsSizeFromBuffer = true;
+
+      setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_POSTFIELDS, binaryData);
+
+      // only kept alive once libcurl is using it
+      if (setOptRetCode == CURLE_OK && this->isZeroCopyEnabled) {
+        this->pinnedBuffers[CURLOPT_POSTFIELDS] = Napi::Persistent(value.As<Napi::Object>());
+      }
     } else {
       if (!value.IsString()) {
-        throw Napi::TypeError::New(env, "Option value must be a string.");
+        throw Napi::TypeError::New(
+            env, isPostFields ? "Option value must be a string, Buffer or ArrayBuffer."
+                              : "Option value must be a string.");
       }
 
-      std::string valueStr = value.As<Napi::String>().Utf8Value();
-
       // libcurl makes a copy of the strings after version 7.17, CURLOPT_POSTFIELD
       // is the only exception
-      if (static_cast<CURLoption>(optionId) == CURLOPT_POSTFIELDS) {
-        std::vector<char> valueChar(valueStr.begin(), valueStr.end());
-        valueChar.push_back(0);
-
-        setOptRetCode =
-            curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), &valueChar[0]);
+      if (isPostFields) {
+        char* postFields = this->arena->CopyString(value);
 
-        if (setOptRetCode == CURLE_OK) {
-          this->toFree->str.push_back(std::move(valueChar));
-        }
+        setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), postFields);
 
       } else {
+        std::string valueStr = value.As<Napi::String>().Utf8Value();
         setOptRetCode =
             curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), valueStr.c_str());
       }
@@ -728,8 +860,17 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       // and not overwrite the READDATA already set in the handle.
       case CURLOPT_READDATA:
         this->readDataFileDescriptor = valueNumber.Int32Value();
+        this->fileReadAhead.reset();
         setOptRetCode = CURLE_OK;
         break;
+      // also enabled by the debug log, which must know if it can disable it when removed
+      case CURLOPT_VERBOSE:
+        setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_VERBOSE,
+                                         static_cast<long>(valueNumber.Int32Value()));
+        if (setOptRetCode == CURLE_OK) {
+          this->isVerboseSetByUser = valueNumber.Int32Value() != 0;
+        }
+        break;
       default:
         setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId),
                                          static_cast<long>(valueNumber.Int32Value()));
@@ -748,16 +889,15 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_CHUNK_BGN_FUNCTION:
         if (isNull) {
           // only unset the CHUNK_DATA if CURLOPT_CHUNK_END_FUNCTION is not set.
-          if (!this->callbacks.count(CURLOPT_CHUNK_END_FUNCTION)) {
+          if (!this->callbacks.Has(CallbackSlot::ChunkEnd)) {
             curl_easy_setopt(this->ch, CURLOPT_CHUNK_DATA, NULL);
           }
-          this->callbacks.erase(CURLOPT_CHUNK_BGN_FUNCTION);
+          this->callbacks.Reset(CallbackSlot::ChunkBgn);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_CHUNK_BGN_FUNCTION, NULL);
         } else {
           // TODO(jonathan): Check if we should use .Reset instead, or if we should clear the value
           // first.
-          this->callbacks[CURLOPT_CHUNK_BGN_FUNCTION] =
-              Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::ChunkBgn, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_CHUNK_DATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_CHUNK_BGN_FUNCTION, Easy::CbChunkBgn);
         }
@@ -765,36 +905,40 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_CHUNK_END_FUNCTION:
         if (isNull) {
           // only unset the CHUNK_DATA if CURLOPT_CHUNK_BGN_FUNCTION is not set.
-          if (!this->callbacks.count(CURLOPT_CHUNK_BGN_FUNCTION)) {
+          if (!this->callbacks.Has(CallbackSlot::ChunkBgn)) {
             curl_easy_setopt(this->ch, CURLOPT_CHUNK_DATA, NULL);
           }
-          this->callbacks.erase(CURLOPT_CHUNK_END_FUNCTION);
+          this->callbacks.Reset(CallbackSlot::ChunkEnd);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_CHUNK_END_FUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_CHUNK_END_FUNCTION] =
-              Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::ChunkEnd, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_CHUNK_DATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_CHUNK_END_FUNCTION, Easy::CbChunkEnd);
         }
         break;
       case CURLOPT_DEBUGFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_DEBUGFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Debug);
+          // still needed by the debug log
+          if (this->debugLog) {
+            setOptRetCode = CURLE_OK;
+            break;
+          }
           curl_easy_setopt(this->ch, CURLOPT_DEBUGDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_DEBUGFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_DEBUGFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Debug, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_DEBUGDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_DEBUGFUNCTION, Easy::CbDebug);
         }
         break;
       case CURLOPT_FNMATCH_FUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_FNMATCH_FUNCTION);
+          this->callbacks.Reset(CallbackSlot::FnMatch);
           curl_easy_setopt(this->ch, CURLOPT_FNMATCH_DATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_FNMATCH_FUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_FNMATCH_FUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::FnMatch, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_FNMATCH_DATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_FNMATCH_FUNCTION, Easy::CbFnMatch);
         }
@@ -802,30 +946,30 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_HEADERFUNCTION:
         setOptRetCode = CURLE_OK;
         if (isNull) {
-          this->callbacks.erase(CURLOPT_HEADERFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Header);
         } else {
-          this->callbacks[CURLOPT_HEADERFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Header, value.As<Napi::Function>());
         }
         break;
 #if NODE_LIBCURL_VER_GE(7, 74, 0)
       case CURLOPT_HSTSREADFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_HSTSREADFUNCTION);
+          this->callbacks.Reset(CallbackSlot::HstsRead);
           curl_easy_setopt(this->ch, CURLOPT_HSTSREADDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_HSTSREADFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_HSTSREADFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::HstsRead, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_HSTSREADDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_HSTSREADFUNCTION, Easy::CbHstsRead);
         }
         break;
       case CURLOPT_HSTSWRITEFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_HSTSWRITEFUNCTION);
+          this->callbacks.Reset(CallbackSlot::HstsWrite);
           curl_easy_setopt(this->ch, CURLOPT_HSTSWRITEDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_HSTSWRITEFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_HSTSWRITEFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::HstsWrite, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_HSTSWRITEDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_HSTSWRITEFUNCTION, Easy::CbHstsWrite);
         }
@@ -833,12 +977,11 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
 #endif
       case CURLOPT_INTERLEAVEFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_INTERLEAVEFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Interleave);
           curl_easy_setopt(this->ch, CURLOPT_INTERLEAVEDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_INTERLEAVEFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_INTERLEAVEFUNCTION] =
-              Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Interleave, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_INTERLEAVEDATA, this);
           setOptRetCode =
               curl_easy_setopt(this->ch, CURLOPT_INTERLEAVEFUNCTION, Easy::CbInterleave);
@@ -847,11 +990,11 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
 #if NODE_LIBCURL_VER_GE(7, 80, 0)
       case CURLOPT_PREREQFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_PREREQFUNCTION);
+          this->callbacks.Reset(CallbackSlot::PreReq);
           curl_easy_setopt(this->ch, CURLOPT_PREREQDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_PREREQFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_PREREQFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::PreReq, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_PREREQDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_PREREQFUNCTION, Easy::CbPreReq);
         }
@@ -859,11 +1002,11 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
 #endif
       case CURLOPT_PROGRESSFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_PROGRESSFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Progress);
           curl_easy_setopt(this->ch, CURLOPT_PROGRESSDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_PROGRESSFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_PROGRESSFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Progress, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_PROGRESSDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_PROGRESSFUNCTION, Easy::CbProgress);
         }
@@ -871,20 +1014,19 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_READFUNCTION:
         setOptRetCode = CURLE_OK;
         if (isNull) {
-          this->callbacks.erase(CURLOPT_READFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Read);
         } else {
-          this->callbacks[CURLOPT_READFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Read, value.As<Napi::Function>());
         }
         break;
 #if NODE_LIBCURL_VER_GE(7, 84, 0)
       case CURLOPT_SSH_HOSTKEYFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_SSH_HOSTKEYFUNCTION);
+          this->callbacks.Reset(CallbackSlot::SshHostKey);
           curl_easy_setopt(this->ch, CURLOPT_SSH_HOSTKEYDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_SSH_HOSTKEYFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_SSH_HOSTKEYFUNCTION] =
-              Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::SshHostKey, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_SSH_HOSTKEYDATA, this);
           setOptRetCode =
               curl_easy_setopt(this->ch, CURLOPT_SSH_HOSTKEYFUNCTION, Easy::CbSshHostKey);
@@ -894,19 +1036,19 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_SEEKFUNCTION:
         setOptRetCode = CURLE_OK;
         if (isNull) {
-          this->callbacks.erase(CURLOPT_SEEKFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Seek);
         } else {
-          this->callbacks[CURLOPT_SEEKFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Seek, value.As<Napi::Function>());
         }
         break;
 #if NODE_LIBCURL_VER_GE(7, 64, 0)
       case CURLOPT_TRAILERFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_TRAILERFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Trailer);
           curl_easy_setopt(this->ch, CURLOPT_TRAILERDATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_TRAILERFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_TRAILERFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Trailer, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_TRAILERDATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_TRAILERFUNCTION, Easy::CbTrailer);
         }
@@ -918,11 +1060,16 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
          if both callbacks are set. */
       case CURLOPT_XFERINFOFUNCTION:
         if (isNull) {
-          this->callbacks.erase(CURLOPT_XFERINFOFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Xferinfo);
+          // still needed by the progress counters
+          if (this->progressCounters) {
+            setOptRetCode = CURLE_OK;
+            break;
+          }
           curl_easy_setopt(this->ch, CURLOPT_XFERINFODATA, NULL);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_XFERINFOFUNCTION, NULL);
         } else {
-          this->callbacks[CURLOPT_XFERINFOFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Xferinfo, value.As<Napi::Function>());
           curl_easy_setopt(this->ch, CURLOPT_XFERINFODATA, this);
           setOptRetCode = curl_easy_setopt(this->ch, CURLOPT_XFERINFOFUNCTION, Easy::CbXferinfo);
         }
@@ -931,17 +1078,22 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       case CURLOPT_WRITEFUNCTION:
         setOptRetCode = CURLE_OK;
         if (isNull) {
-          this->callbacks.erase(CURLOPT_WRITEFUNCTION);
+          this->callbacks.Reset(CallbackSlot::Write);
         } else {
-          this->callbacks[CURLOPT_WRITEFUNCTION] = Napi::Persistent(value.As<Napi::Function>());
+          this->callbacks.Set(CallbackSlot::Write, value.As<Napi::Function>());
         }
         break;
     }
     // check if option is a blob, and the value is correct
   } else if ((optionId = IsInsideCurlConstantStruct(curlOptionBlob, opt))) {
 #if NODE_LIBCURL_VER_GE(7, 71, 0)
+    CURLoption blobOption = static_cast<CURLoption>(optionId);
+    char* binaryData = nullptr;
+    size_t binaryLength = 0;
+
     if (value.IsNull()) {
-      setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), NULL);
+      setOptRetCode = curl_easy_setopt(this->ch, blobOption, NULL);
+      this->pinnedBuffers.erase(blobOption);
     } else if (value.IsString()) {
       std::string stringValue = value.As<Napi::String>().Utf8Value();
       size_t length = static_cast<size_t>(stringValue.length());
@@ -949,17 +1101,25 @@ Napi::Value Easy::SetOpt(const Napi::CallbackInfo& info) {
       blob.data = stringValue.data();
       blob.len = length;
       blob.flags = CURL_BLOB_COPY;
-      // if we wanted to reduce copies, we could store the string in our toFree vector
-      setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), &blob);
-    } else if (value.IsBuffer()) {
-      Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+      // if we wanted to reduce copies, we could store the string in the arena
+      setOptRetCode = curl_easy_setopt(this->ch, blobOption, &blob);
+      this->pinnedBuffers.erase(blobOption);
+    } else if (GetBinaryData(value, &binaryData, &binaryLength)) {
       struct curl_blob blob;
-      blob.data = buffer.Data();
-      blob.len = buffer.Length();
-      blob.flags = CURL_BLOB_COPY;
-      setOptRetCode = curl_easy_setopt(this->ch, static_cast<CURLoption>(optionId), &blob);
+      blob.data = binaryData;
+      blob.len = binaryLength;
+      blob.flags = this->isZeroCopyEnabled ? CURL_BLOB_NOCOPY : CURL_BLOB_COPY;
+      setOptRetCode = curl_easy_setopt(this->ch, blobOption, &blob);
+
+      if (setOptRetCode == CURLE_OK) {
+        if (this->isZeroCopyEnabled) {
+          this->pinnedBuffers[blobOption] = Napi::Persistent(value.As<Napi::Object>());
+        } else {
+          this->pinnedBuffers.erase(blobOption);
+        }
+      }
     } else {
-      throw Napi::TypeError::New(env, "Option value must be a string or Buffer.");
+      throw Napi::TypeError::New(env, "Option value must be a string, Buffer or ArrayBuffer.");
     }
 #else
     throw CurlError::New(env, "Blob options require curl 7.71 or newer.", CURLE_NOT_BUILT_IN);
@@ -1120,9 +1280,29 @@ Napi::Value Easy::Perform(const Napi::CallbackInfo& info) {
 
   NODE_LIBCURL_DEBUG_LOG(this, "Easy::Perform", "performing request");
 
+  // cancelled before it even started
+  if (this->isCancelled) {
+    this->OnTransferEnd(CURLE_ABORTED_BY_CALLBACK);
+    return Napi::Number::New(env, static_cast<int>(CURLE_ABORTED_BY_CALLBACK));
+  }
+
+  this->OnTransferStart();
+
+  Trace::Span span(Trace::Event::EasyPerform, 0, this->id);
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
+
   LocaleGuard localeGuard;
   CURLcode code = curl_easy_perform(this->ch);
 
+  if (code != CURLE_OK && this->isCancelled) {
+    code = CURLE_ABORTED_BY_CALLBACK;
+  }
+
+  span.value = code;
+
+  this->OnTransferEnd(code);
+  env.GetInstanceData<Curl>()->SyncTrackedMemory();
+
   return Napi::Number::New(env, static_cast<int>(code));
 }
 
@@ -1134,6 +1314,7 @@ Napi::Value Easy::Reset(const Napi::CallbackInfo& info) {
   }
 
   NODE_LIBCURL_DEBUG_LOG(this, "Easy::Reset", "resetting request");
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
 
   curl_easy_reset(this->ch);
 
@@ -1141,16 +1322,652 @@ Napi::Value Easy::Reset(const Napi::CallbackInfo& info) {
   // https://github.com/bagder/curl/commit/ac6da721a3740500cc0764947385eb1c22116b83
   curl_easy_setopt(this->ch, CURLOPT_URL, "");
 
+  // DisposeInternalData releases the arena, take it first so its memory can be reused
+  // if no duplicated handle is still sharing it.
+  std::shared_ptr<Arena> arena = std::move(this->arena);
+
   this->DisposeInternalData();
 
-  // the above will reset toFree, thus we need to recreate it
-  this->toFree = std::make_shared<Easy::ToFree>();
+  if (arena.use_count() == 1) {
+    arena->Reset();
+  } else {
+    arena = std::make_shared<Arena>();
+  }
+  this->arena = std::move(arena);
 
   this->ResetRequiredHandleOptions(false);
 
   return info.This();
 }
 
+Napi::Value Easy::SetZeroCopy(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    throw Napi::TypeError::New(env, "Argument must be a boolean.");
+  }
+
+  // values already set are kept as they are, this only affects the next ones.
+  this->isZeroCopyEnabled = info[0].As<Napi::Boolean>().Value();
+
+  return info.This();
+}
+
+Napi::Value Easy::SetUploadBuffers(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    // the size was set from the buffers, unknown again until set by the caller
+    if (this->uploadSource) {
+      curl_easy_setopt(this->ch, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(-1));
+    }
+
+    this->uploadSource.reset();
+    return info.This();
+  }
+
+  if (!value.IsArray()) {
+    throw Napi::TypeError::New(env, "Argument must be an Array of Buffers or null.");
+  }
+
+  Napi::Array array = value.As<Napi::Array>();
+  uint32_t length = array.Length();
+
+  std::vector<BufferListUploadSource::Segment> segments;
+  std::vector<Napi::ObjectReference> references;
+  segments.reserve(length);
+  references.reserve(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value item = array.Get(i);
+    char* data = nullptr;
+    size_t dataLength = 0;
+
+    if (!GetBinaryData(item, &data, &dataLength)) {
+      throw Napi::TypeError::New(env, "Array items must be Buffers, ArrayBuffers or views.");
+    }
+
+    segments.push_back({data, dataLength});
+    references.push_back(Napi::Persistent(item.As<Napi::Object>()));
+  }
+
+  auto source =
+      std::make_unique<BufferListUploadSource>(std::move(segments), std::move(references));
+
+  // so the Content-Length can be sent, instead of a chunked upload
+  curl_easy_setopt(this->ch, CURLOPT_INFILESIZE_LARGE, source->Size());
+
+  this->uploadSource = std::move(source);
+
+  return info.This();
+}
+
+Napi::Value Easy::SetUploadFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    // the size was set from the file, unknown again until set by the caller
+    if (this->uploadSource) {
+      curl_easy_setopt(this->ch, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(-1));
+    }
+
+    this->uploadSource.reset();
+    return info.This();
+  }
+
+  if (!value.IsString()) {
+    throw Napi::TypeError::New(env, "Path must be a string or null.");
+  }
+
+  curl_off_t offset = 0;
+  curl_off_t length = -1;
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsObject()) {
+      throw Napi::TypeError::New(env, "Options must be an object.");
+    }
+
+    Napi::Object options = info[1].As<Napi::Object>();
+    Napi::Value offsetValue = options.Get("offset");
+    Napi::Value lengthValue = options.Get("length");
+
+    if (!offsetValue.IsUndefined()) {
+      if (!offsetValue.IsNumber()) {
+        throw Napi::TypeError::New(env, "The offset option must be a number.");
+      }
+      offset = static_cast<curl_off_t>(offsetValue.As<Napi::Number>().Int64Value());
+    }
+
+    if (!lengthValue.IsUndefined()) {
+      if (!lengthValue.IsNumber()) {
+        throw Napi::TypeError::New(env, "The length option must be a number.");
+      }
+      length = static_cast<curl_off_t>(lengthValue.As<Napi::Number>().Int64Value());
+    }
+
+    if (offset < 0 || (!lengthValue.IsUndefined() && length < 0)) {
+      throw Napi::RangeError::New(env, "The offset and length options must not be negative.");
+    }
+  }
+
+  std::string path = value.As<Napi::String>().Utf8Value();
+  std::string error;
+  auto source = MappedFileUploadSource::Open(path, offset, length, &error);
+
+  if (!source) {
+    throw Napi::Error::New(env, "Could not map the file \"" + path + "\": " + error);
+  }
+
+  // so the Content-Length can be sent, instead of a chunked upload
+  curl_easy_setopt(this->ch, CURLOPT_INFILESIZE_LARGE, source->Size());
+
+  this->uploadSource = std::move(source);
+
+  return info.This();
+}
+
+Napi::Value Easy::SetDownloadFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    this->writeDataFileDescriptor = -1;
+    return info.This();
+  }
+
+  if (!value.IsNumber()) {
+    throw Napi::TypeError::New(env, "File descriptor must be a number or null.");
+  }
+
+  curl_off_t offset = 0;
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      throw Napi::TypeError::New(env, "Offset must be a number.");
+    }
+    offset = static_cast<curl_off_t>(info[1].As<Napi::Number>().Int64Value());
+  }
+
+  this->writeDataFileDescriptor = value.As<Napi::Number>().Int32Value();
+  this->writeDataOffset = offset;
+  this->writeDataBytesWritten = 0;
+
+  return info.This();
+}
+
+Napi::Value Easy::SetReadBufferMode(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    throw Napi::TypeError::New(env, "Argument must be a ReadBufferMode.");
+  }
+
+  int32_t mode = info[0].As<Napi::Number>().Int32Value();
+
+  if (mode < static_cast<int32_t>(ReadBufferMode::Copy) ||
+      mode > static_cast<int32_t>(ReadBufferMode::Borrowed)) {
+    throw Napi::RangeError::New(env, "Invalid ReadBufferMode.");
+  }
+
+  this->readBufferMode = static_cast<ReadBufferMode>(mode);
+  this->readBufferPool.Reset();
+
+  return info.This();
+}
+
+Napi::Value Easy::Cancel(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  if (this->isCancelled) {
+    return info.This();
+  }
+
+  NODE_LIBCURL_DEBUG_LOG(this, "Easy::Cancel", "cancelling transfer");
+
+  this->isCancelled = true;
+
+  // used as the cause of the error the transfer fails with
+  if (info.Length() > 0 && info[0].IsObject()) {
+    this->callbackError = Napi::Persistent(info[0].As<Napi::Object>());
+  }
+
+  if (this->multi) {
+    this->multi->CancelHandle(this);
+  }
+
+  return info.This();
+}
+
+Napi::Value Easy::SetDebugLog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    // it was only enabled for the debug log, libcurl would print to stderr otherwise
+    if (this->debugLog && !this->isVerboseSetByUser) {
+      curl_easy_setopt(this->ch, CURLOPT_VERBOSE, 0L);
+    }
+
+    this->debugLog.reset();
+
+    if (!this->callbacks.Has(CallbackSlot::Debug)) {
+      curl_easy_setopt(this->ch, CURLOPT_DEBUGDATA, NULL);
+      curl_easy_setopt(this->ch, CURLOPT_DEBUGFUNCTION, NULL);
+    }
+
+    return info.This();
+  }
+
+  if (!value.IsObject()) {
+    throw Napi::TypeError::New(env, "Argument must be an object or null.");
+  }
+
+  Napi::Object options = value.As<Napi::Object>();
+
+  auto getOption = [&](const char* name, uint32_t defaultValue, uint32_t min,
+                       uint32_t max) -> uint32_t {
+    Napi::Value option = options.Get(name);
+
+    if (option.IsUndefined()) {
+      return defaultValue;
+    }
+
+    if (!option.IsNumber()) {
+      throw Napi::TypeError::New(env, std::string("Option ") + name + " must be a number.");
+    }
+
+    double number = option.As<Napi::Number>().DoubleValue();
+    if (!(number >= min && number <= max) || std::floor(number) != number) {
+      throw Napi::RangeError::New(env, std::string("Option ") + name +
+                                           " must be an integer between " + std::to_string(min) +
+                                           " and " + std::to_string(max) + ".");
+    }
+
+    return static_cast<uint32_t>(number);
+  };
+
+  uint32_t capacity = getOption("capacity", 1024, 1, 1 << 20);
+  uint32_t maxDataSize = getOption("maxDataSize", 256, 0, 1 << 20);
+
+  // the payloads are left out by default, they are the bulk of the output
+  uint32_t typeMask = (1u << CURLINFO_TEXT) | (1u << CURLINFO_HEADER_IN) |
+                      (1u << CURLINFO_HEADER_OUT);
+
+  Napi::Value types = options.Get("types");
+  if (!types.IsUndefined()) {
+    if (!types.IsArray()) {
+      throw Napi::TypeError::New(env, "Option types must be an array.");
+    }
+
+    Napi::Array typesArray = types.As<Napi::Array>();
+    typeMask = 0;
+
+    for (uint32_t i = 0; i < typesArray.Length(); i++) {
+      Napi::Value type = typesArray.Get(i);
+      if (!type.IsNumber() || type.As<Napi::Number>().Int32Value() < 0 ||
+          type.As<Napi::Number>().Int32Value() >= CURLINFO_END) {
+        throw Napi::TypeError::New(env, "Option types must only have CurlInfoDebug values.");
+      }
+      typeMask |= 1u << type.As<Napi::Number>().Int32Value();
+    }
+  }
+
+  if (static_cast<uint64_t>(capacity) * maxDataSize > (uint64_t{1} << 30)) {
+    throw Napi::RangeError::New(env, "The debug log must not be larger than 1 GiB.");
+  }
+
+  this->debugLog = std::make_unique<NodeLibcurl::DebugLog>(capacity, maxDataSize, typeMask);
+
+  // libcurl only calls the DEBUGFUNCTION while VERBOSE is enabled
+  curl_easy_setopt(this->ch, CURLOPT_VERBOSE, 1L);
+  curl_easy_setopt(this->ch, CURLOPT_DEBUGDATA, this);
+  curl_easy_setopt(this->ch, CURLOPT_DEBUGFUNCTION, Easy::CbDebug);
+
+  return info.This();
+}
+
+Napi::Value Easy::DrainDebugLog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  if (!this->debugLog) {
+    throw CurlError::New(env, "The debug log is not enabled, call setDebugLog first.",
+                         CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("dropped", Napi::Number::New(env, static_cast<double>(this->debugLog->Dropped())));
+  result.Set("entries", this->debugLog->Drain(env, this->id));
+
+  return result;
+}
+
+Napi::Value Easy::SetProgressThrottle(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    this->progressThrottle = ProgressThrottle();
+    return info.This();
+  }
+
+  if (!value.IsObject()) {
+    throw Napi::TypeError::New(env, "Argument must be an object or null.");
+  }
+
+  Napi::Object options = value.As<Napi::Object>();
+
+  auto getOption = [&](const char* name) -> double {
+    Napi::Value option = options.Get(name);
+
+    if (option.IsUndefined()) {
+      return 0;
+    }
+
+    if (!option.IsNumber()) {
+      throw Napi::TypeError::New(env, std::string("Option ") + name + " must be a number.");
+    }
+
+    double number = option.As<Napi::Number>().DoubleValue();
+    if (!(number >= 0)) {
+      throw Napi::RangeError::New(env, std::string("Option ") + name + " must not be negative.");
+    }
+
+    return number;
+  };
+
+  double interval = getOption("interval");
+  double bytes = getOption("bytes");
+  double percentage = getOption("percentage");
+
+  this->progressThrottle = ProgressThrottle();
+  this->progressThrottle.intervalNs = static_cast<uint64_t>(interval * 1e6);
+  this->progressThrottle.minBytes = static_cast<curl_off_t>(bytes);
+  this->progressThrottle.minPercentage = percentage;
+
+  return info.This();
+}
+
+Napi::Value Easy::SetProgressCounters(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->isOpen) {
+    throw CurlError::New(env, "Curl handle is closed.", CURLE_BAD_FUNCTION_ARGUMENT);
+  }
+
+  Napi::Value value = info[0];
+
+  if (value.IsNull() || value.IsUndefined()) {
+    this->progressCountersArray.Reset();
+    this->progressCounters = nullptr;
+    // the XFERINFOFUNCTION is kept, otherwise libcurl would print its own progress meter
+    return info.This();
+  }
+
+#if NODE_LIBCURL_VER_GE(7, 32, 0)
+  if (!value.IsTypedArray()) {
+    throw Napi::TypeError::New(env, "Argument must be a Float64Array, a BigInt64Array or null.");
+  }
+
+  Napi::TypedArray array = value.As<Napi::TypedArray>();
+  napi_typedarray_type type = array.TypedArrayType();
+
+  if (type != napi_float64_array && type != napi_bigint64_array) {
+    throw Napi::TypeError::New(env, "Argument must be a Float64Array, a BigInt64Array or null.");
+  }
+
+  if (array.ElementLength() < static_cast<size_t>(ProgressCounter::Count)) {
+    throw Napi::RangeError::New(
+        env, "Array must have at least " +
+                 std::to_string(static_cast<int32_t>(ProgressCounter::Count)) + " elements.");
+  }
+
+  this->progressCountersArray = Napi::Persistent(array.As<Napi::Object>());
+  this->isProgressCountersBigInt = type == napi_bigint64_array;
+  // this already includes the offset of the array inside its buffer, which can be shared
+  if (this->isProgressCountersBigInt) {
+    this->progressCounters = value.As<Napi::BigInt64Array>().Data();
+  } else {
+    this->progressCounters = value.As<Napi::Float64Array>().Data();
+  }
+
+  for (int32_t i = 0; i < static_cast<int32_t>(ProgressCounter::Count); i++) {
+    this->StoreProgressCounter(static_cast<ProgressCounter>(i), 0);
+  }
+
+  // the counters are updated by the xferinfo callback, even if there is no JS one
+  curl_easy_setopt(this->ch, CURLOPT_XFERINFODATA, this);
+  curl_easy_setopt(this->ch, CURLOPT_XFERINFOFUNCTION, Easy::CbXferinfo);
+  curl_easy_setopt(this->ch, CURLOPT_NOPROGRESS, 0L);
+
+  return info.This();
+#else
+  throw CurlError::New(env, "Progress counters require libcurl 7.32.0 or newer.",
+                       CURLE_NOT_BUILT_IN);
+#endif
+}
+
+void Easy::StoreProgressCounter(ProgressCounter counter, double value) {
+  auto index = static_cast<size_t>(counter);
+
+  // relaxed atomic stores, so they are never torn for other threads reading the same memory
+  if (this->isProgressCountersBigInt) {
+    std::atomic_ref<int64_t>(static_cast<int64_t*>(this->progressCounters)[index])
+        .store(static_cast<int64_t>(value), std::memory_order_relaxed);
+  } else {
+    std::atomic_ref<double>(static_cast<double*>(this->progressCounters)[index])
+        .store(value, std::memory_order_relaxed);
+  }
+}
+
+void Easy::UpdateProgressCounters(curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                                  curl_off_t ulnow) {
+  if (!this->progressCounters) {
+    return;
+  }
+
+  this->StoreProgressCounter(ProgressCounter::DownloadTotal, static_cast<double>(dltotal));
+  this->StoreProgressCounter(ProgressCounter::DownloadNow, static_cast<double>(dlnow));
+  this->StoreProgressCounter(ProgressCounter::UploadTotal, static_cast<double>(ultotal));
+  this->StoreProgressCounter(ProgressCounter::UploadNow, static_cast<double>(ulnow));
+  this->UpdateProgressSpeeds();
+
+  TransferPhase phase = TransferPhase::Connecting;
+
+  if (dlnow > 0) {
+    phase = TransferPhase::Receiving;
+  } else if (ulnow > 0 && (ultotal <= 0 || ulnow < ultotal)) {
+    phase = TransferPhase::Sending;
+  } else {
+#if NODE_LIBCURL_VER_GE(7, 61, 0)
+    curl_off_t connectTime = 0;
+    curl_easy_getinfo(this->ch, CURLINFO_CONNECT_TIME_T, &connectTime);
+#else
+    double connectTime = 0;
+    curl_easy_getinfo(this->ch, CURLINFO_CONNECT_TIME, &connectTime);
+#endif
+    if (connectTime > 0 || ulnow > 0) {
+      phase = TransferPhase::Waiting;
+    }
+  }
+
+  this->StoreProgressCounter(ProgressCounter::Phase, static_cast<double>(phase));
+}
+
+void Easy::UpdateProgressSpeeds() {
+#if NODE_LIBCURL_VER_GE(7, 55, 0)
+  curl_off_t downloadSpeed = 0;
+  curl_off_t uploadSpeed = 0;
+  curl_easy_getinfo(this->ch, CURLINFO_SPEED_DOWNLOAD_T, &downloadSpeed);
+  curl_easy_getinfo(this->ch, CURLINFO_SPEED_UPLOAD_T, &uploadSpeed);
+#else
+  double downloadSpeed = 0;
+  double uploadSpeed = 0;
+  curl_easy_getinfo(this->ch, CURLINFO_SPEED_DOWNLOAD, &downloadSpeed);
+  curl_easy_getinfo(this->ch, CURLINFO_SPEED_UPLOAD, &uploadSpeed);
+#endif
+
+  this->StoreProgressCounter(ProgressCounter::DownloadSpeed, static_cast<double>(downloadSpeed));
+  this->StoreProgressCounter(ProgressCounter::UploadSpeed, static_cast<double>(uploadSpeed));
+}
+
+void Easy::OnTransferStart() {
+  this->isTransferRunning = true;
+
+  if (Trace::IsEnabled()) {
+    this->traceTransferStart = uv_hrtime();
+    Trace::Write(Trace::Event::EasyTransferStart, 0, this->id, -1, 0, this->traceTransferStart, 0);
+  } else {
+    this->traceTransferStart = 0;
+  }
+  this->transferAsyncContext =
+      std::make_shared<Napi::AsyncContext>(Env(), "Easy::Transfer", this->Value());
+
+  // the blocks read ahead, and its EOF, were for the previous transfer. The next one starts
+  // reading again from readDataOffset, like the synchronous reads do.
+  this->fileReadAhead.reset();
+
+  // the buffers or the file set with setUploadBuffers or setUploadFile are uploaded in full
+  // by every transfer, the previous one may have left them at the end.
+  if (this->uploadSource) {
+    this->uploadSource->Seek(0, SEEK_SET);
+  }
+
+  // so the first tick of the transfer is always reported
+  this->progressThrottle.hasReported = false;
+
+  if (this->progressCounters) {
+    for (int32_t i = 0; i < static_cast<int32_t>(ProgressCounter::Count); i++) {
+      this->StoreProgressCounter(static_cast<ProgressCounter>(i), 0);
+    }
+    this->StoreProgressCounter(ProgressCounter::Phase,
+                               static_cast<double>(TransferPhase::Connecting));
+  }
+}
+
+std::shared_ptr<Napi::AsyncContext> Easy::GetCallbackAsyncContext(const char* resourceName) {
+  if (this->transferAsyncContext) {
+    return this->transferAsyncContext;
+  }
+
+  // like the HSTS callbacks, which libcurl also calls when the handle is closed
+  return std::make_shared<Napi::AsyncContext>(Env(), resourceName);
+}
+
+void Easy::OnTransferEnd(CURLcode code) {
+  this->isTransferRunning = false;
+
+  NODE_LIBCURL_TRACE(EasyTransferEnd, 0, this->id, -1, code);
+  if (this->traceTransferStart != 0 && Trace::IsEnabled()) {
+    this->TraceTransferTimes();
+  }
+  this->transferAsyncContext.reset();
+  // the cancellation was for this transfer, the next one can run
+  this->isCancelled = false;
+
+  if (this->progressCounters) {
+    // the last tick may have happened before the final speeds were calculated
+    this->UpdateProgressSpeeds();
+    this->StoreProgressCounter(
+        ProgressCounter::Phase,
+        static_cast<double>(code == CURLE_OK ? TransferPhase::Done : TransferPhase::Failed));
+  }
+}
+
+void Easy::TraceTransferTimes() {
+#if NODE_LIBCURL_VER_GE(7, 61, 0)
+  static constexpr std::pair<Trace::TransferTime, CURLINFO> infos[] = {
+#if NODE_LIBCURL_VER_GE(8, 6, 0)
+      {Trace::TransferTime::Queue, CURLINFO_QUEUE_TIME_T},
+#endif
+      {Trace::TransferTime::NameLookup, CURLINFO_NAMELOOKUP_TIME_T},
+      {Trace::TransferTime::Connect, CURLINFO_CONNECT_TIME_T},
+      {Trace::TransferTime::AppConnect, CURLINFO_APPCONNECT_TIME_T},
+      {Trace::TransferTime::PreTransfer, CURLINFO_PRETRANSFER_TIME_T},
+      {Trace::TransferTime::StartTransfer, CURLINFO_STARTTRANSFER_TIME_T},
+      {Trace::TransferTime::Total, CURLINFO_TOTAL_TIME_T},
+  };
+
+  for (const auto& [time, info] : infos) {
+    curl_off_t us = 0;
+    if (curl_easy_getinfo(this->ch, info, &us) != CURLE_OK) continue;
+
+    Trace::Write(Trace::Event::EasyTransferTime, 0, this->id, -1, static_cast<int32_t>(time),
+                 this->traceTransferStart, static_cast<uint64_t>(us) * 1000);
+  }
+#endif
+}
+
+bool Easy::ProgressThrottle::ShouldReport(curl_off_t dltotal, curl_off_t dlnow,
+                                          curl_off_t ultotal, curl_off_t ulnow) {
+  if (!this->IsEnabled()) {
+    return true;
+  }
+
+  uint64_t now = uv_hrtime();
+  curl_off_t bytes = dlnow + ulnow;
+  curl_off_t total = dltotal + ultotal;
+  double percentage = total > 0 ? static_cast<double>(bytes) * 100 / static_cast<double>(total) : 0;
+
+  bool shouldReport =
+      // the first and last ticks of a transfer are always reported
+      !this->hasReported || (total > 0 && bytes == total && bytes != this->lastBytes) ||
+      (this->intervalNs > 0 && now - this->lastTime >= this->intervalNs) ||
+      (this->minBytes > 0 && bytes - this->lastBytes >= this->minBytes) ||
+      (this->minPercentage > 0 && total > 0 &&
+       std::abs(percentage - this->lastPercentage) >= this->minPercentage);
+
+  if (shouldReport) {
+    this->hasReported = true;
+    this->lastTime = now;
+    this->lastBytes = bytes;
+    this->lastPercentage = percentage;
+  }
+
+  return shouldReport;
+}
+
 Napi::Value Easy::Close(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
 
@@ -1475,24 +2292,40 @@ Napi::Value Easy::UnmonitorSocketEvents(const Napi::CallbackInfo& info) {
 
 size_t Easy::WriteFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
   Easy* obj = static_cast<Easy*>(userdata);
-  return obj->OnData(ptr, size, nmemb);
+  // returning less than what was given aborts the transfer
+  if (obj->isCancelled) return 0;
+
+  NODE_LIBCURL_PROBE2(easy__data__start, obj->id, size * nmemb);
+  size_t result = obj->OnData(ptr, size, nmemb);
+  NODE_LIBCURL_PROBE3(easy__data__done, obj->id, size * nmemb, result);
+
+  return result;
 }
 
 size_t Easy::HeaderFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
   Easy* obj = static_cast<Easy*>(userdata);
-  return obj->OnHeader(ptr, size, nmemb);
+  if (obj->isCancelled) return 0;
+
+  NODE_LIBCURL_PROBE2(easy__header__start, obj->id, size * nmemb);
+  size_t result = obj->OnHeader(ptr, size, nmemb);
+  NODE_LIBCURL_PROBE3(easy__header__done, obj->id, size * nmemb, result);
+
+  return result;
 }
 
 size_t Easy::OnData(char* data, size_t size, size_t nmemb) {
   NODE_LIBCURL_DEBUG_LOG(this, "Easy::OnData", "received data");
 
+  size_t dataLength = size * nmemb;
+
+  if (this->writeDataFileDescriptor != -1) {
+    return this->WriteToDownloadFile(data, dataLength);
+  }
+
   Napi::Env env = Env();
   Napi::HandleScope scope(env);
 
-  size_t dataLength = size * nmemb;
-
-  auto it = this->callbacks.find(CURLOPT_WRITEFUNCTION);
-  if (it == this->callbacks.end() || it->second.IsEmpty()) {
+  if (!this->callbacks.Has(CallbackSlot::Write)) {
     // No callback set, return data length to continue
     return dataLength;
   }
@@ -1501,16 +2334,16 @@ size_t Easy::OnData(char* data, size_t size, size_t nmemb) {
   int32_t returnValue = -1;
 
   try {
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = this->callbacks.Get(CallbackSlot::Write);
 
     Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, data, dataLength);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::OnData");
+    auto asyncContext = this->GetCallbackAsyncContext("Easy::OnData");
+    auto span = this->TraceCallback(CallbackSlot::Write);
 
     Napi::Value result = cb.MakeCallback(
         this->Value(), {buffer, Napi::Number::New(env, size), Napi::Number::New(env, nmemb)},
-        asyncContext);
+        *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1541,14 +2374,51 @@ size_t Easy::OnData(char* data, size_t size, size_t nmemb) {
   return returnValue;
 }
 
+// Writes the data at the current position of the download file. Returning less than length
+// makes libcurl fail the transfer with CURLE_WRITE_ERROR.
+//
+// The write is synchronous, so it blocks the event loop while the disk is busy, unlike the
+// READDATA reads inside a Multi handle. Writing on the threadpool would mean keeping a copy of
+// every chunk and pausing the transfer while writes are pending, which is not done for now.
+size_t Easy::WriteToDownloadFile(char* data, size_t length) {
+  uv_loop_t* loop = nullptr;
+  if (napi_get_uv_event_loop(this->Env(), &loop) != napi_ok) {
+    return 0;
+  }
+
+  size_t written = 0;
+
+  while (written < length) {
+    // a negative offset means writing at the current file position
+    curl_off_t offset = this->writeDataOffset < 0
+                            ? -1
+                            : this->writeDataOffset + this->writeDataBytesWritten;
+
+    uv_fs_t writeReq;
+    uv_buf_t uvbuf = uv_buf_init(data + written, static_cast<unsigned int>(length - written));
+
+    int result = uv_fs_write(loop, &writeReq, this->writeDataFileDescriptor, &uvbuf, 1, offset,
+                             NULL);
+    uv_fs_req_cleanup(&writeReq);
+
+    if (result <= 0) {
+      break;
+    }
+
+    written += static_cast<size_t>(result);
+    this->writeDataBytesWritten += result;
+  }
+
+  return written;
+}
+
 size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
   Napi::Env env = Env();
   Napi::HandleScope scope(env);
 
   size_t dataLength = size * nmemb;
 
-  auto it = this->callbacks.find(CURLOPT_HEADERFUNCTION);
-  if (it == this->callbacks.end() || it->second.IsEmpty()) {
+  if (!this->callbacks.Has(CallbackSlot::Header)) {
     // No callback set, return data length to continue
     return dataLength;
   }
@@ -1557,16 +2427,16 @@ size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
   int32_t returnValue = -1;
 
   try {
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = this->callbacks.Get(CallbackSlot::Header);
 
     // Create buffer from data
     Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, data, dataLength);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::OnHeader");
+    auto asyncContext = this->GetCallbackAsyncContext("Easy::OnHeader");
+    auto span = this->TraceCallback(CallbackSlot::Header);
     Napi::Value result = cb.MakeCallback(
         this->Value(), {buffer, Napi::Number::New(env, size), Napi::Number::New(env, nmemb)},
-        asyncContext);
+        *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1594,33 +2464,108 @@ size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
   return returnValue;
 }
 
+// Returns the Buffer to be passed to the READFUNCTION callback, isBorrowed is set to true
+// if it is backed by ptr itself, in which case it must be detached after the callback returns.
+Napi::Buffer<char> Easy::GetReadFunctionBuffer(char* ptr, size_t size, bool* isBorrowed) {
+  Napi::Env env = this->Env();
+  *isBorrowed = false;
+
+  if (this->readBufferMode == ReadBufferMode::Borrowed) {
+    napi_value result;
+    napi_status status = napi_create_external_buffer(env, size, ptr, nullptr, nullptr, &result);
+
+    if (status == napi_ok) {
+      *isBorrowed = true;
+      return Napi::Buffer<char>(env, result);
+    }
+
+    // some runtimes, like Electron, do not allow external buffers, use the pool instead.
+    if (status != napi_no_external_buffers_allowed) {
+      throw Napi::Error::New(env);
+    }
+  } else if (this->readBufferMode == ReadBufferMode::Copy) {
+    return Napi::Buffer<char>::New(env, size);
+  }
+
+  // libcurl usually asks for the same size every time, so the same Buffer can be reused.
+  if (!this->readBufferPool.IsEmpty()) {
+    Napi::Buffer<char> buffer = this->readBufferPool.Value();
+    if (buffer.Length() == size) {
+      return buffer;
+    }
+  }
+
+#ifdef NODE_API_EXPERIMENTAL_HAS_CREATE_BUFFER_FROM_ARRAYBUFFER
+  // otherwise create a Buffer with the requested size over the same memory, if it fits.
+  Napi::ArrayBuffer arrayBuffer;
+  if (!this->readBufferPool.IsEmpty() &&
+      this->readBufferPool.Value().ArrayBuffer().ByteLength() >= size) {
+    arrayBuffer = this->readBufferPool.Value().ArrayBuffer();
+  } else {
+    arrayBuffer = Napi::ArrayBuffer::New(env, size);
+  }
+
+  napi_value result;
+  napi_status status =
+      node_api_create_buffer_from_arraybuffer(env, arrayBuffer, 0, size, &result);
+  if (status != napi_ok) {
+    throw Napi::Error::New(env);
+  }
+
+  Napi::Buffer<char> buffer(env, result);
+#else
+  Napi::Buffer<char> buffer = Napi::Buffer<char>::New(env, size);
+#endif
+
+  this->readBufferPool = Napi::Persistent(buffer);
+
+  return buffer;
+}
+
+// Makes sure a Buffer created over libcurl memory cannot be used by JS anymore.
+void Easy::DetachBorrowedBuffer(Napi::Env env, const Napi::Buffer<char>& buffer) {
+  napi_value arrayBuffer;
+  if (napi_get_typedarray_info(env, buffer, nullptr, nullptr, nullptr, &arrayBuffer, nullptr) ==
+      napi_ok) {
+    napi_detach_arraybuffer(env, arrayBuffer);
+  }
+}
+
 // Called by libcurl as soon as it needs to read data in order to send it to the
 // peer
 size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
   Easy* obj = static_cast<Easy*>(userdata);
 
+  if (obj->isCancelled) return CURL_READFUNC_ABORT;
+
   int32_t returnValue = CURL_READFUNC_ABORT;
   int32_t fd = obj->readDataFileDescriptor;
   size_t n = size * nmemb;
 
-  auto it = obj->callbacks.find(CURLOPT_READFUNCTION);
-
   // Read callback was set, use it instead
-  if (it != obj->callbacks.end() && !it->second.IsEmpty()) {
+  if (obj->callbacks.Has(CallbackSlot::Read)) {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
+    Napi::Buffer<char> buffer;
+    bool isBufferBorrowed = false;
+
     try {
-      Napi::Function cb = it->second.Value();
+      Napi::Function cb = obj->callbacks.Get(CallbackSlot::Read);
 
-      Napi::Buffer<char> buffer = Napi::Buffer<char>::New(env, static_cast<uint32_t>(n));
+      buffer = obj->GetReadFunctionBuffer(ptr, n, &isBufferBorrowed);
 
-      // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-      Napi::AsyncContext asyncContext(env, "Easy::ReadFunction");
+      auto asyncContext = obj->GetCallbackAsyncContext("Easy::ReadFunction");
+      auto span = obj->TraceCallback(CallbackSlot::Read);
 
       Napi::Value result = cb.MakeCallback(
           obj->Value(), {buffer, Napi::Number::New(env, size), Napi::Number::New(env, nmemb)},
-          asyncContext);
+          *asyncContext);
+
+      if (isBufferBorrowed) {
+        isBufferBorrowed = false;
+        DetachBorrowedBuffer(env, buffer);
+      }
 
       // This is in theory not needed, as we have exceptions enabled
       if (env.IsExceptionPending()) {
@@ -1641,31 +2586,31 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
       returnValue = result.As<Napi::Number>().Int32Value();
 
       char* data = buffer.Data();
-      bool hasData = !!data && returnValue > 0 && returnValue < CURL_READFUNC_ABORT;
+      bool hasData = !!data && returnValue > 0 && returnValue < CURL_READFUNC_ABORT &&
+                     static_cast<size_t>(returnValue) <= n;
 
-      if (hasData) {
+      // when borrowed, the callback already wrote to ptr
+      if (hasData && data != ptr) {
         std::memcpy(ptr, data, returnValue);
       }
 
     } catch (const Napi::Error& e) {
+      if (isBufferBorrowed) {
+        DetachBorrowedBuffer(env, buffer);
+      }
+
       obj->throwErrorMultiInterfaceAware(e);
       return returnValue;
     }
 
+  } else if (obj->uploadSource) {
+    returnValue = static_cast<int32_t>(obj->uploadSource->Read(ptr, n));
   } else {
     // abort early if we don't have a file descriptor
     if (fd == -1) {
       return CURL_READFUNC_ABORT;
     }
 
-    // get the offset
-    curl_off_t offset = obj->readDataOffset;
-    if (offset >= 0) {
-      obj->readDataOffset += n;
-    }
-
-    uv_fs_t readReq;
-
     uv_loop_t* loop = nullptr;
     auto napi_result = napi_get_uv_event_loop(obj->Env(), &loop);
 
@@ -1673,14 +2618,41 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
       return CURL_READFUNC_ABORT;
     }
 
+    // inside a Multi handle the event loop keeps running during the transfer, so we can read
+    // the file on the threadpool, pausing the transfer while the data is not ready.
+    if (obj->isInsideMultiHandle) {
+      if (!obj->fileReadAhead) {
+        obj->fileReadAhead = std::make_unique<FileReadAheadUploadSource>(
+            loop, fd, obj->readDataOffset, [obj]() {
+              obj->pauseState &= ~CURLPAUSE_SEND;
+              curl_easy_pause(obj->ch, obj->pauseState);
+            });
+      }
+
+      returnValue = static_cast<int32_t>(obj->fileReadAhead->Read(ptr, n));
+
+      // keep the offset in sync with what libcurl consumed, like the synchronous reads do
+      if (obj->readDataOffset >= 0 && returnValue > 0 && returnValue < CURL_READFUNC_ABORT) {
+        obj->readDataOffset += returnValue;
+      }
+    } else {
+      // get the offset
+      curl_off_t offset = obj->readDataOffset;
+      if (offset >= 0) {
+        obj->readDataOffset += n;
+      }
+
+      uv_fs_t readReq;
+
 #if UV_VERSION_MAJOR < 1
-    returnValue = uv_fs_read(loop, &readReq, fd, ptr, n, offset, NULL);
+      returnValue = uv_fs_read(loop, &readReq, fd, ptr, n, offset, NULL);
 #else
-    uv_buf_t uvbuf = uv_buf_init(ptr, (unsigned int)(n));
+      uv_buf_t uvbuf = uv_buf_init(ptr, (unsigned int)(n));
 
-    returnValue = uv_fs_read(loop, &readReq, fd, &uvbuf, 1, offset, NULL);
+      returnValue = uv_fs_read(loop, &readReq, fd, &uvbuf, 1, offset, NULL);
 #endif
-    uv_fs_req_cleanup(&readReq);
+      uv_fs_req_cleanup(&readReq);
+    }
   }
 
   if (returnValue < 0) {
@@ -1697,29 +2669,27 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
 size_t Easy::SeekFunction(void* userdata, curl_off_t offset, int origin) {
   Easy* obj = static_cast<Easy*>(userdata);
 
-  int32_t returnValue = CURL_SEEKFUNC_FAIL;
+  if (obj->isCancelled) return CURL_SEEKFUNC_FAIL;
 
-  auto readIt = obj->callbacks.find(CURLOPT_READFUNCTION);
+  int32_t returnValue = CURL_SEEKFUNC_FAIL;
 
   // Read callback was set, look for a seek callback
-  if (readIt != obj->callbacks.end()) {
-    auto seekIt = obj->callbacks.find(CURLOPT_SEEKFUNCTION);
-
-    if (seekIt != obj->callbacks.end() && !seekIt->second.IsEmpty()) {
+  if (obj->callbacks.Has(CallbackSlot::Read)) {
+    if (obj->callbacks.Has(CallbackSlot::Seek)) {
       Napi::Env env = obj->Env();
       Napi::HandleScope scope(env);
 
       try {
-        Napi::Function cb = seekIt->second.Value();
+        Napi::Function cb = obj->callbacks.Get(CallbackSlot::Seek);
 
-        // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-        Napi::AsyncContext asyncContext(env, "Easy::SeekFunction");
+        auto asyncContext = obj->GetCallbackAsyncContext("Easy::SeekFunction");
+        auto span = obj->TraceCallback(CallbackSlot::Seek);
 
         Napi::Value result =
             cb.MakeCallback(obj->Value(),
                             {Napi::Number::New(env, static_cast<uint32_t>(offset)),
                              Napi::Number::New(env, static_cast<uint32_t>(origin))},
-                            asyncContext);
+                            *asyncContext);
 
         // This is in theory not needed, as we have exceptions enabled
         if (env.IsExceptionPending()) {
@@ -1749,6 +2719,11 @@ size_t Easy::SeekFunction(void* userdata, curl_off_t offset, int origin) {
       returnValue = CURL_SEEKFUNC_CANTSEEK;
     }
 
+  } else if (obj->uploadSource) {
+    returnValue = obj->uploadSource->Seek(offset, origin);
+  } else if (obj->fileReadAhead) {
+    obj->readDataOffset = offset;
+    returnValue = obj->fileReadAhead->Seek(offset, origin);
   } else {
     // default implementation
     obj->readDataOffset = offset;
@@ -1764,8 +2739,7 @@ long Easy::CbChunkBgn(curl_fileinfo* transferInfo, void* ptr, int remains) {
   assert(obj);
 
   // Check if we have a CHUNK_BGN callback
-  auto it = obj->callbacks.find(CURLOPT_CHUNK_BGN_FUNCTION);
-  assert(it != obj->callbacks.end() && "CHUNK_BGN callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::ChunkBgn) && "CHUNK_BGN callback not set.");
 
   int32_t returnValue = CURL_CHUNK_BGN_FUNC_FAIL;
 
@@ -1773,15 +2747,15 @@ long Easy::CbChunkBgn(curl_fileinfo* transferInfo, void* ptr, int remains) {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::ChunkBgn);
 
     Napi::Object fileInfoObj = CreateV8ObjectFromCurlFileInfo(env, transferInfo);
     Napi::Number remainsArg = Napi::Number::New(env, remains);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbChunkBgn");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbChunkBgn");
+    auto span = obj->TraceCallback(CallbackSlot::ChunkBgn);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {fileInfoObj, remainsArg}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {fileInfoObj, remainsArg}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1812,8 +2786,7 @@ long Easy::CbChunkEnd(void* ptr) {
   assert(obj);
 
   // Check if we have a CHUNK_END callback
-  auto it = obj->callbacks.find(CURLOPT_CHUNK_END_FUNCTION);
-  assert(it != obj->callbacks.end() && "CHUNK_END callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::ChunkEnd) && "CHUNK_END callback not set.");
 
   int32_t returnValue = CURL_CHUNK_END_FUNC_FAIL;
 
@@ -1821,12 +2794,12 @@ long Easy::CbChunkEnd(void* ptr) {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::ChunkEnd);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbChunkEnd");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbChunkEnd");
+    auto span = obj->TraceCallback(CallbackSlot::ChunkEnd);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1856,9 +2829,14 @@ int Easy::CbDebug(CURL* handle, curl_infotype type, char* data, size_t size, voi
 
   assert(obj);
 
-  // Check if we have a DEBUG callback
-  auto it = obj->callbacks.find(CURLOPT_DEBUGFUNCTION);
-  assert(it != obj->callbacks.end() && "DEBUG callback not set.");
+  if (obj->debugLog && obj->debugLog->Accepts(type)) {
+    obj->debugLog->Record(type, data, size);
+  }
+
+  // this is also installed for the debug log
+  if (!obj->callbacks.Has(CallbackSlot::Debug)) {
+    return 0;
+  }
 
   int32_t returnValue = 1;
 
@@ -1866,15 +2844,15 @@ int Easy::CbDebug(CURL* handle, curl_infotype type, char* data, size_t size, voi
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::Debug);
 
     Napi::Number typeArg = Napi::Number::New(env, static_cast<int32_t>(type));
     Napi::Buffer<char> bufferArg = Napi::Buffer<char>::Copy(env, data, size);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbDebug");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbDebug");
+    auto span = obj->TraceCallback(CallbackSlot::Debug);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {typeArg, bufferArg}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {typeArg, bufferArg}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1905,8 +2883,7 @@ int Easy::CbFnMatch(void* ptr, const char* pattern, const char* string) {
   assert(obj);
 
   // Check if we have a FNMATCH callback
-  auto it = obj->callbacks.find(CURLOPT_FNMATCH_FUNCTION);
-  assert(it != obj->callbacks.end() && "FNMATCH callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::FnMatch) && "FNMATCH callback not set.");
 
   int32_t returnValue = CURL_FNMATCHFUNC_FAIL;
 
@@ -1914,15 +2891,15 @@ int Easy::CbFnMatch(void* ptr, const char* pattern, const char* string) {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::FnMatch);
 
     Napi::String patternStr = Napi::String::New(env, pattern);
     Napi::String stringStr = Napi::String::New(env, string);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbFnMatch");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbFnMatch");
+    auto span = obj->TraceCallback(CallbackSlot::FnMatch);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {patternStr, stringStr}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {patternStr, stringStr}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -1958,13 +2935,20 @@ int Easy::CbProgress(void* clientp, double dltotal, double dlnow, double ultotal
   //  https://curl.haxx.se/mail/lib-2014-06/0062.html
   // This was fixed here
   //  https://github.com/curl/curl/commit/907520c4b93616bddea15757bbf0bfb45cde8101
-  if (obj->isCbProgressAlreadyAborted) {
+  if (obj->isCbProgressAlreadyAborted || obj->isCancelled) {
     return returnValue;
   }
 
   // Check if we have a progress callback
-  auto it = obj->callbacks.find(CURLOPT_PROGRESSFUNCTION);
-  if (it == obj->callbacks.end() || it->second.IsEmpty()) {
+  if (!obj->callbacks.Has(CallbackSlot::Progress)) {
+    return 0;
+  }
+
+  // paused transfers are resumed from the callback, so they always get it
+  if (obj->pauseState == 0 &&
+      !obj->progressThrottle.ShouldReport(
+          static_cast<curl_off_t>(dltotal), static_cast<curl_off_t>(dlnow),
+          static_cast<curl_off_t>(ultotal), static_cast<curl_off_t>(ulnow))) {
     return 0;
   }
 
@@ -1972,17 +2956,16 @@ int Easy::CbProgress(void* clientp, double dltotal, double dlnow, double ultotal
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::Progress);
 
-    // async context
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbProgress");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbProgress");
+    auto span = obj->TraceCallback(CallbackSlot::Progress);
 
     Napi::Value result =
         cb.MakeCallback(obj->Value(),
                         {Napi::Number::New(env, dltotal), Napi::Number::New(env, dlnow),
                          Napi::Number::New(env, ultotal), Napi::Number::New(env, ulnow)},
-                        asyncContext);
+                        *asyncContext);
 
     // Check if an exception occurred during callback execution
     if (env.IsExceptionPending()) {
@@ -2021,29 +3004,37 @@ int Easy::CbXferinfo(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_o
   int32_t returnValue = 1;
 
   // same check than above, see it for comments.
-  if (obj->isCbProgressAlreadyAborted) {
+  if (obj->isCbProgressAlreadyAborted || obj->isCancelled) {
     return returnValue;
   }
 
+  obj->UpdateProgressCounters(dltotal, dlnow, ultotal, ulnow);
+
   // Check if we have a xferinfo callback
-#if NODE_LIBCURL_VER_GE(7, 32, 0)
-  auto it = obj->callbacks.find(CURLOPT_XFERINFOFUNCTION);
-#else
-  // just to make it compile ¯\_(ツ)_/¯
-  auto it = obj->callbacks.end();
-#endif
+  // this is also installed for the progress counters, in which case libcurl does not call
+  // the PROGRESSFUNCTION anymore, so we do it ourselves
+  if (!obj->callbacks.Has(CallbackSlot::Xferinfo)) {
+    if (obj->callbacks.Has(CallbackSlot::Progress)) {
+      return Easy::CbProgress(clientp, static_cast<double>(dltotal), static_cast<double>(dlnow),
+                              static_cast<double>(ultotal), static_cast<double>(ulnow));
+    }
 
-  assert(it != obj->callbacks.end() && "XFERINFO callback not set.");
+    return 0;
+  }
+
+  if (obj->pauseState == 0 &&
+      !obj->progressThrottle.ShouldReport(dltotal, dlnow, ultotal, ulnow)) {
+    return 0;
+  }
 
   try {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::Xferinfo);
 
-    // async context
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbXferinfo");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbXferinfo");
+    auto span = obj->TraceCallback(CallbackSlot::Xferinfo);
 
     // Call the callback with proper error handling
     Napi::Value result = cb.MakeCallback(obj->Value(),
@@ -2051,7 +3042,7 @@ int Easy::CbXferinfo(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_o
                                           Napi::Number::New(env, static_cast<double>(dlnow)),
                                           Napi::Number::New(env, static_cast<double>(ultotal)),
                                           Napi::Number::New(env, static_cast<double>(ulnow))},
-                                         asyncContext);
+                                         *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -2087,8 +3078,7 @@ int Easy::CbHstsRead(CURL* handle, struct curl_hstsentry* sts, void* userdata) {
   assert(obj);
 
   // Check if we have a HSTS read callback
-  auto it = obj->callbacks.find(CURLOPT_HSTSREADFUNCTION);
-  assert(it != obj->callbacks.end() && "HSTSREADFUNCTION callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::HstsRead) && "HSTSREADFUNCTION callback not set.");
 
   int32_t returnValue = CURLSTS_FAIL;
 
@@ -2120,15 +3110,15 @@ int Easy::CbHstsRead(CURL* handle, struct curl_hstsentry* sts, void* userdata) {
         return CURLSTS_DONE;
       }
 
-      Napi::Function cb = it->second.Value();
+      Napi::Function cb = obj->callbacks.Get(CallbackSlot::HstsRead);
 
-      // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-      Napi::AsyncContext asyncContext(env, "Easy::CbHstsRead");
+      auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbHstsRead");
+      auto span = obj->TraceCallback(CallbackSlot::HstsRead);
 
       Napi::Object cbArg = Napi::Object::New(env);
       cbArg.Set("maxHostLengthBytes", Napi::Number::New(env, sts->namelen));
 
-      Napi::Value result = cb.MakeCallback(obj->Value(), {cbArg}, asyncContext);
+      Napi::Value result = cb.MakeCallback(obj->Value(), {cbArg}, *asyncContext);
 
       // This is in theory not needed, as we have exceptions enabled
       if (env.IsExceptionPending()) {
@@ -2278,8 +3268,7 @@ int Easy::CbHstsWrite(CURL* handle, struct curl_hstsentry* sts, struct curl_inde
   assert(obj);
 
   // Check if we have a HSTS write callback
-  auto it = obj->callbacks.find(CURLOPT_HSTSWRITEFUNCTION);
-  assert(it != obj->callbacks.end() && "HSTSWRITEFUNCTION callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::HstsWrite) && "HSTSWRITEFUNCTION callback not set.");
 
   int32_t returnValue = CURLSTS_FAIL;
 
@@ -2287,7 +3276,7 @@ int Easy::CbHstsWrite(CURL* handle, struct curl_hstsentry* sts, struct curl_inde
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::HstsWrite);
 
     // Create the count object
     Napi::Object countObj = Napi::Object::New(env);
@@ -2296,10 +3285,10 @@ int Easy::CbHstsWrite(CURL* handle, struct curl_hstsentry* sts, struct curl_inde
 
     Napi::Object hstsEntry = CreateV8ObjectFromCurlHstsEntry(env, sts);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbHstsWrite");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbHstsWrite");
+    auto span = obj->TraceCallback(CallbackSlot::HstsWrite);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {hstsEntry, countObj}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {hstsEntry, countObj}, *asyncContext);
 
     if (env.IsExceptionPending()) {
       Napi::Error error = env.GetAndClearPendingException();
@@ -2336,25 +3325,24 @@ int Easy::CbPreReq(void* clientp, char* conn_primary_ip, char* conn_local_ip, in
   assert(obj);
 
   // Check if we have a prereq callback
-  auto it = obj->callbacks.find(CURLOPT_PREREQFUNCTION);
-  assert(it != obj->callbacks.end() && "Pre req callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::PreReq) && "Pre req callback not set.");
 
   try {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::PreReq);
 
     Napi::String connPrimaryIp = Napi::String::New(env, conn_primary_ip);
     Napi::String connLocalIp = Napi::String::New(env, conn_local_ip);
     Napi::Number connPrimaryPort = Napi::Number::New(env, conn_primary_port);
     Napi::Number connLocalPort = Napi::Number::New(env, conn_local_port);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbPreReq");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbPreReq");
+    auto span = obj->TraceCallback(CallbackSlot::PreReq);
 
     Napi::Value result = cb.MakeCallback(
-        obj->Value(), {connPrimaryIp, connLocalIp, connPrimaryPort, connLocalPort}, asyncContext);
+        obj->Value(), {connPrimaryIp, connLocalIp, connPrimaryPort, connLocalPort}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -2392,19 +3380,18 @@ int Easy::CbTrailer(struct curl_slist** headerList, void* userdata) {
   assert(obj);
 
   // Check if we have a trailer callback
-  auto it = obj->callbacks.find(CURLOPT_TRAILERFUNCTION);
-  assert(it != obj->callbacks.end() && "Trailer callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::Trailer) && "Trailer callback not set.");
 
   try {
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::Trailer);
 
-    // TODO(jonathan, migration): capture this when perform is called (either on Easy or Multi)
-    Napi::AsyncContext asyncContext(env, "Easy::CbTrailer");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbTrailer");
+    auto span = obj->TraceCallback(CallbackSlot::Trailer);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {}, *asyncContext);
 
     // This is in theory not needed, as we have exceptions enabled
     if (env.IsExceptionPending()) {
@@ -2465,8 +3452,7 @@ size_t Easy::CbInterleave(void* ptr, size_t size, size_t nmemb, void* userdata)
   assert(obj);
 
   // Check if we have an INTERLEAVE callback
-  auto it = obj->callbacks.find(CURLOPT_INTERLEAVEFUNCTION);
-  assert(it != obj->callbacks.end() && "INTERLEAVE callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::Interleave) && "INTERLEAVE callback not set.");
 
   size_t realSize = size * nmemb;
   size_t returnValue = realSize;
@@ -2475,16 +3461,17 @@ size_t Easy::CbInterleave(void* ptr, size_t size, size_t nmemb, void* userdata)
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::Interleave);
 
     Napi::Buffer<char> bufferArg = Napi::Buffer<char>::Copy(env, static_cast<char*>(ptr), realSize);
     Napi::Number sizeArg = Napi::Number::New(env, static_cast<double>(size));
     Napi::Number nmembArg = Napi::Number::New(env, static_cast<double>(nmemb));
 
-    Napi::AsyncContext asyncContext(env, "Easy::CbInterleave");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbInterleave");
+    auto span = obj->TraceCallback(CallbackSlot::Interleave);
 
     Napi::Value result =
-        cb.MakeCallback(obj->Value(), {bufferArg, sizeArg, nmembArg}, asyncContext);
+        cb.MakeCallback(obj->Value(), {bufferArg, sizeArg, nmembArg}, *asyncContext);
 
     if (env.IsExceptionPending()) {
       Napi::Error error = env.GetAndClearPendingException();
@@ -2516,8 +3503,7 @@ int Easy::CbSshHostKey(void* clientp, int keytype, const char* key, size_t keyle
   assert(obj);
 
   // Check if we have an SSH_HOSTKEYFUNCTION callback
-  auto it = obj->callbacks.find(CURLOPT_SSH_HOSTKEYFUNCTION);
-  assert(it != obj->callbacks.end() && "SSH_HOSTKEYFUNCTION callback not set.");
+  assert(obj->callbacks.Has(CallbackSlot::SshHostKey) && "SSH_HOSTKEYFUNCTION callback not set.");
 
   int returnValue = 1;  // Default to CURLKHMATCH_MISMATCH
 
@@ -2525,14 +3511,15 @@ int Easy::CbSshHostKey(void* clientp, int keytype, const char* key, size_t keyle
     Napi::Env env = obj->Env();
     Napi::HandleScope scope(env);
 
-    Napi::Function cb = it->second.Value();
+    Napi::Function cb = obj->callbacks.Get(CallbackSlot::SshHostKey);
 
     Napi::Number keytypeArg = Napi::Number::New(env, static_cast<int32_t>(keytype));
     Napi::Buffer<char> keyArg = Napi::Buffer<char>::Copy(env, key, keylen);
 
-    Napi::AsyncContext asyncContext(env, "Easy::CbSshHostKey");
+    auto asyncContext = obj->GetCallbackAsyncContext("Easy::CbSshHostKey");
+    auto span = obj->TraceCallback(CallbackSlot::SshHostKey);
 
-    Napi::Value result = cb.MakeCallback(obj->Value(), {keytypeArg, keyArg}, asyncContext);
+    Napi::Value result = cb.MakeCallback(obj->Value(), {keytypeArg, keyArg}, *asyncContext);
 
     if (env.IsExceptionPending()) {
       Napi::Error error = env.GetAndClearPendingException();
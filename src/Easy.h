@@ -6,6 +6,11 @@
  */
 #pragma once
 
+#include "Arena.h"
+#include "CallbackTable.h"
+#include "DebugLog.h"
+#include "Trace.h"
+#include "UploadSource.h"
 #include "macros.h"
 
 #include <curl/curl.h>
@@ -25,6 +30,12 @@ extern const napi_type_tag EASY_TYPE_TAG;
 // Forward declaration
 class Multi;
 
+#ifdef NODE_LIBCURL_BENCHMARKS
+namespace Benchmarks {
+class EasyAccess;
+}  // namespace Benchmarks
+#endif
+
 class Easy : public Napi::ObjectWrap<Easy> {
  public:
   Easy(const Napi::CallbackInfo& info);
@@ -49,6 +60,16 @@ class Easy : public Napi::ObjectWrap<Easy> {
   Napi::Value OnSocketEvent(const Napi::CallbackInfo& info);
   Napi::Value MonitorSocketEvents(const Napi::CallbackInfo& info);
   Napi::Value UnmonitorSocketEvents(const Napi::CallbackInfo& info);
+  Napi::Value SetZeroCopy(const Napi::CallbackInfo& info);
+  Napi::Value SetUploadBuffers(const Napi::CallbackInfo& info);
+  Napi::Value SetUploadFile(const Napi::CallbackInfo& info);
+  Napi::Value SetDownloadFile(const Napi::CallbackInfo& info);
+  Napi::Value SetReadBufferMode(const Napi::CallbackInfo& info);
+  Napi::Value SetProgressThrottle(const Napi::CallbackInfo& info);
+  Napi::Value SetProgressCounters(const Napi::CallbackInfo& info);
+  Napi::Value SetDebugLog(const Napi::CallbackInfo& info);
+  Napi::Value DrainDebugLog(const Napi::CallbackInfo& info);
+  Napi::Value Cancel(const Napi::CallbackInfo& info);
   Napi::Value Close(const Napi::CallbackInfo& info);
 
   static Napi::Value StrError(const Napi::CallbackInfo& info);
@@ -64,11 +85,17 @@ class Easy : public Napi::ObjectWrap<Easy> {
   Napi::Value GetterPauseFlags(const Napi::CallbackInfo& info);
   Napi::Value GetterIsPausedRecv(const Napi::CallbackInfo& info);
   Napi::Value GetterIsPausedSend(const Napi::CallbackInfo& info);
+  Napi::Value GetterDownloadFileBytesWritten(const Napi::CallbackInfo& info);
 
   // Public members
   CURL* ch;
   bool isInsideMultiHandle = false;
+  // Multi handle this was added to, while isInsideMultiHandle is true
+  Multi* multi = nullptr;
   bool isOpen = true;
+  // Set by Easy#cancel, the libcurl callbacks abort the transfer without calling into JS
+  bool isCancelled = false;
+  bool isTransferRunning = false;
   int32_t pauseState = 0;
   uint64_t id;
 
@@ -78,10 +105,16 @@ class Easy : public Napi::ObjectWrap<Easy> {
   // Helper to create Easy from CURL handle
   static Napi::Object FromCURLHandle(Napi::Env env, CURL* handle);
 
- private:
-  // Internal class for cleanup management
-  class ToFree;
+  // Must be called when a transfer of this handle starts and ends, either by Easy::Perform
+  // or by a Multi handle
+  void OnTransferStart();
+  void OnTransferEnd(CURLcode code);
+
+  // Async context to call the JS callbacks with. While a transfer is running it is the one
+  // captured when it started, otherwise a new one is created with the given resource name.
+  std::shared_ptr<Napi::AsyncContext> GetCallbackAsyncContext(const char* resourceName);
 
+ private:
   // Private methods
   void Dispose();
   void DisposeInternalData();
@@ -93,13 +126,24 @@ class Easy : public Napi::ObjectWrap<Easy> {
   void inline throwErrorMultiInterfaceAware(const Napi::Error& error) noexcept;
 
   size_t OnData(char* data, size_t size, size_t nmemb);
+  size_t WriteToDownloadFile(char* data, size_t length);
   size_t OnHeader(char* data, size_t size, size_t nmemb);
 
   // Callback management
-  typedef std::map<CURLoption, Napi::FunctionReference> CallbacksMap;
-  CallbacksMap callbacks;
+  CallbackTable callbacks;
   Napi::FunctionReference cbOnSocketEvent;
   std::shared_ptr<Napi::AsyncContext> cbOnSocketEventAsyncContext;
+  // Captured by OnTransferStart, so AsyncLocalStorage and async_hooks see every callback of a
+  // transfer as coming from the call that started it
+  std::shared_ptr<Napi::AsyncContext> transferAsyncContext;
+  // uv_hrtime() of the start of the current transfer, only set while the trace is enabled
+  uint64_t traceTransferStart = 0;
+
+  // Records the time spent in a JS callback into the trace, if it is enabled.
+  Trace::Span TraceCallback(CallbackSlot slot) const noexcept {
+    return Trace::Span(Trace::Event::EasyCallback, 0, this->id, -1, static_cast<int32_t>(slot));
+  }
+  void TraceTransferTimes();
 
   // Members for socket monitoring
   uv_poll_t* socketPollHandle = nullptr;
@@ -108,12 +152,89 @@ class Easy : public Napi::ObjectWrap<Easy> {
   // Members for progress callback
   bool isCbProgressAlreadyAborted = false;
 
+  // Limits how often the PROGRESSFUNCTION and XFERINFOFUNCTION callbacks are called,
+  // the ticks skipped return 0 to libcurl without calling into JS.
+  struct ProgressThrottle {
+    uint64_t intervalNs = 0;
+    curl_off_t minBytes = 0;
+    double minPercentage = 0;
+
+    // values of the last tick reported
+    bool hasReported = false;
+    uint64_t lastTime = 0;
+    curl_off_t lastBytes = 0;
+    double lastPercentage = 0;
+
+    bool IsEnabled() const { return intervalNs > 0 || minBytes > 0 || minPercentage > 0; }
+    bool ShouldReport(curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+  };
+  ProgressThrottle progressThrottle;
+
+  // Caller supplied memory the progress of the transfer is written to on every tick,
+  // see lib/enum/ProgressCounter.ts for the layout, and lib/enum/TransferPhase.ts for the phases
+  enum class ProgressCounter : int32_t {
+    DownloadTotal = 0,
+    DownloadNow = 1,
+    UploadTotal = 2,
+    UploadNow = 3,
+    DownloadSpeed = 4,
+    UploadSpeed = 5,
+    Phase = 6,
+    Count = 7
+  };
+  enum class TransferPhase : int32_t {
+    Idle = 0,
+    Connecting = 1,
+    Sending = 2,
+    Waiting = 3,
+    Receiving = 4,
+    Done = 5,
+    Failed = 6
+  };
+  // keeps the memory alive, the values are written directly to progressCounters
+  Napi::ObjectReference progressCountersArray;
+  void* progressCounters = nullptr;
+  bool isProgressCountersBigInt = false;
+  void StoreProgressCounter(ProgressCounter counter, double value);
+  void UpdateProgressCounters(curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                              curl_off_t ulnow);
+  void UpdateProgressSpeeds();
+
+  // Set by Easy#setDebugLog, CbDebug records into it before calling the DEBUGFUNCTION, if any
+  std::unique_ptr<NodeLibcurl::DebugLog> debugLog;
+  // VERBOSE was enabled with setOpt, so removing the debug log leaves it enabled
+  bool isVerboseSetByUser = false;
+
   // File operations
   int32_t readDataFileDescriptor = -1;
   curl_off_t readDataOffset = -1;
+  // Data served natively by ReadFunction, used when there is no READFUNCTION callback
+  std::unique_ptr<UploadSource> uploadSource = nullptr;
+  // Reads READDATA ahead on the threadpool when inside a Multi handle, created on the first read
+  std::unique_ptr<UploadSource> fileReadAhead = nullptr;
+
+  // The response body is written to this file descriptor, starting at writeDataOffset,
+  // instead of being passed to the WRITEFUNCTION callback
+  int32_t writeDataFileDescriptor = -1;
+  curl_off_t writeDataOffset = 0;
+  curl_off_t writeDataBytesWritten = 0;
 
-  // Memory management
-  std::shared_ptr<ToFree> toFree = nullptr;
+  // How the Buffer passed to the READFUNCTION callback is created, see lib/enum/ReadBufferMode.ts
+  enum class ReadBufferMode : int32_t { Copy = 0, Pooled = 1, Borrowed = 2 };
+  ReadBufferMode readBufferMode = ReadBufferMode::Copy;
+  // last Buffer created when using ReadBufferMode::Pooled
+  Napi::Reference<Napi::Buffer<char>> readBufferPool;
+  Napi::Buffer<char> GetReadFunctionBuffer(char* ptr, size_t size, bool* isBorrowed);
+  static void DetachBorrowedBuffer(Napi::Env env, const Napi::Buffer<char>& buffer);
+
+  // Memory needed by the options currently set, shared with duplicated handles
+  std::shared_ptr<Arena> arena = nullptr;
+
+  // Buffers used directly by libcurl, instead of a copy of them, when zero copy is enabled
+  bool isZeroCopyEnabled = false;
+  std::map<CURLoption, Napi::ObjectReference> pinnedBuffers;
+  // if POSTFIELDSIZE_LARGE was set by us because POSTFIELDS was given binary data
+  bool isPostFieldsSizeFromBuffer = false;
 
   // HSTS cache
   std::vector<Napi::Reference<Napi::Object>> hstsReadCache;
@@ -155,6 +276,10 @@ class Easy : public Napi::ObjectWrap<Easy> {
   static Napi::Object CreateV8ObjectFromCurlHstsEntry(Napi::Env env, struct curl_hstsentry* sts);
 #endif
 
+#ifdef NODE_LIBCURL_BENCHMARKS
+  friend class Benchmarks::EasyAccess;
+#endif
+
   // Prevent copying
   Easy(const Easy& that) = delete;
   Easy& operator=(const Easy& that) = delete;
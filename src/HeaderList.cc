@@ -0,0 +1,73 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "HeaderList.h"
+
+namespace NodeLibcurl {
+
+HeaderList::HeaderList(const Napi::CallbackInfo& info) : Napi::ObjectWrap<HeaderList>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    throw Napi::TypeError::New(env, "HeaderList requires an Array of strings.");
+  }
+
+  auto storage = std::make_shared<Storage>();
+  curl_slist** next = &storage->first;
+
+  Napi::Array items = info[0].As<Napi::Array>();
+
+  for (uint32_t i = 0, len = items.Length(); i < len; ++i) {
+    Napi::Value item = items.Get(i);
+
+    if (!item.IsString()) {
+      throw Napi::TypeError::New(env, "HeaderList items must be strings.");
+    }
+
+    *next = storage->arena.NewSlistNode(storage->arena.CopyString(item));
+    next = &(*next)->next;
+    storage->length++;
+  }
+
+  this->storage = std::move(storage);
+}
+
+Napi::Function HeaderList::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(
+      env, "HeaderList",
+      {// Instance methods
+       InstanceMethod("toArray", &HeaderList::ToArray),
+
+       // Property accessors
+       InstanceAccessor(
+           "length", &HeaderList::GetterLength, nullptr,
+           static_cast<napi_property_attributes>(napi_enumerable | napi_configurable))});
+
+  exports.Set("HeaderList", func);
+  return func;
+}
+
+Napi::Value HeaderList::ToArray(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Array result = Napi::Array::New(env, this->storage->length);
+
+  uint32_t i = 0;
+  for (curl_slist* node = this->storage->first; node; node = node->next) {
+    result.Set(i++, Napi::String::New(env, node->data));
+  }
+
+  return result;
+}
+
+Napi::Value HeaderList::GetterLength(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), this->storage->length);
+}
+
+}  // namespace NodeLibcurl
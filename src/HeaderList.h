@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "Arena.h"
+
+#include <curl/curl.h>
+
+#include <memory>
+#include <napi.h>
+
+namespace NodeLibcurl {
+
+// Immutable curl_slist that is built once and can be set on any number of Easy handles.
+class HeaderList : public Napi::ObjectWrap<HeaderList> {
+ public:
+  // The nodes are never modified after the list is created. The storage is shared by this
+  // object and every Easy handle using the list, so it lives until the last one releases it.
+  struct Storage {
+    Arena arena;
+    curl_slist* first = nullptr;
+    uint32_t length = 0;
+  };
+
+  static Napi::Function Init(Napi::Env env, Napi::Object exports);
+
+  // Constructor - must be public for ObjectWrap
+  HeaderList(const Napi::CallbackInfo& info);
+
+  std::shared_ptr<const Storage> storage;
+
+ private:
+  // Copy constructors cannot be used
+  HeaderList(const HeaderList& that) = delete;
+  HeaderList& operator=(const HeaderList& that) = delete;
+
+  // Instance methods
+  Napi::Value ToArray(const Napi::CallbackInfo& info);
+
+  // Property getters
+  Napi::Value GetterLength(const Napi::CallbackInfo& info);
+};
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "MemoryTracker.h"
+
+#include "Allocator.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+
+namespace NodeLibcurl::MemoryTracker {
+
+std::atomic<bool> enabled{false};
+
+namespace {
+
+constexpr size_t kCategoryCount = static_cast<size_t>(Category::Count);
+
+// Counters of a thread. Blocks can be freed by other threads, or after the thread that
+// allocated them exited, so each live block holds a reference to the counters it was counted on,
+// and the thread holds one more while it is alive.
+struct Counters {
+  std::atomic<int64_t> bytes[kCategoryCount] = {};
+  std::atomic<int64_t> refs{1};
+
+  void Add(Category category, int64_t size) noexcept {
+    this->bytes[static_cast<size_t>(category)].fetch_add(size, std::memory_order_relaxed);
+    this->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Remove(Category category, int64_t size) noexcept {
+    this->bytes[static_cast<size_t>(category)].fetch_sub(size, std::memory_order_relaxed);
+    this->Release();
+  }
+
+  void Release() noexcept {
+    if (this->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+};
+
+// Kept in front of each block, the size keeps the block aligned like malloc would.
+struct alignas(std::max_align_t) Header {
+  Counters* counters;
+  uint64_t size : 56;
+  uint64_t category : 8;
+};
+
+constexpr size_t kHeaderSize = sizeof(Header);
+
+// where the tracked blocks are allocated from
+const Allocator::Functions* backend = &Allocator::System();
+
+// Used by the threads whose counters were already released, while they exit, never freed.
+Counters exitedThreadCounters;
+
+thread_local Counters* threadCounters = nullptr;
+thread_local Category threadCategory = Category::Other;
+
+// Releases the reference of the thread to its counters when it exits.
+struct ThreadCountersOwner {
+  ~ThreadCountersOwner() {
+    if (threadCounters && threadCounters != &exitedThreadCounters) {
+      threadCounters->Release();
+    }
+    threadCounters = &exitedThreadCounters;
+  }
+};
+
+thread_local ThreadCountersOwner threadCountersOwner;
+
+Counters* GetThreadCounters() noexcept {
+  if (!threadCounters) {
+    threadCounters = new (std::nothrow) Counters();
+    if (!threadCounters) {
+      threadCounters = &exitedThreadCounters;
+    } else {
+      // makes sure the owner is constructed, so it is destroyed when the thread exits
+      (void)&threadCountersOwner;
+    }
+  }
+
+  return threadCounters;
+}
+
+void* Track(Header* header, size_t size, Category category) noexcept {
+  Counters* counters = GetThreadCounters();
+  counters->Add(category, static_cast<int64_t>(size));
+
+  header->counters = counters;
+  header->size = size;
+  header->category = static_cast<uint64_t>(category);
+
+  return reinterpret_cast<char*>(header) + kHeaderSize;
+}
+
+Header* HeaderOf(void* ptr) noexcept {
+  return reinterpret_cast<Header*>(static_cast<char*>(ptr) - kHeaderSize);
+}
+
+void* TrackedMalloc(size_t size) {
+  if (size > std::numeric_limits<size_t>::max() - kHeaderSize) return nullptr;
+
+  auto header = static_cast<Header*>(backend->malloc(kHeaderSize + size));
+  if (!header) return nullptr;
+
+  return Track(header, size, threadCategory);
+}
+
+void TrackedFree(void* ptr) {
+  if (!ptr) return;
+
+  Header* header = HeaderOf(ptr);
+  header->counters->Remove(static_cast<Category>(header->category),
+                           static_cast<int64_t>(header->size));
+
+  backend->free(header);
+}
+
+void* TrackedRealloc(void* ptr, size_t size) {
+  if (!ptr) return TrackedMalloc(size);
+  if (size > std::numeric_limits<size_t>::max() - kHeaderSize) return nullptr;
+
+  Header* header = HeaderOf(ptr);
+  Counters* previousCounters = header->counters;
+  auto category = static_cast<Category>(header->category);
+  auto previousSize = static_cast<int64_t>(header->size);
+
+  auto newHeader = static_cast<Header*>(backend->realloc(header, kHeaderSize + size));
+  // the original block is left untouched
+  if (!newHeader) return nullptr;
+
+  // a block that grows keeps its category, but is now counted on the current thread
+  previousCounters->Remove(category, previousSize);
+  return Track(newHeader, size, category);
+}
+
+char* TrackedStrdup(const char* str) {
+  size_t size = std::strlen(str) + 1;
+
+  auto copy = static_cast<char*>(TrackedMalloc(size));
+  if (copy) std::memcpy(copy, str, size);
+
+  return copy;
+}
+
+void* TrackedCalloc(size_t count, size_t size) {
+  if (size != 0 && count > (std::numeric_limits<size_t>::max() - kHeaderSize) / size) {
+    return nullptr;
+  }
+
+  auto header = static_cast<Header*>(backend->calloc(1, kHeaderSize + count * size));
+  if (!header) return nullptr;
+
+  return Track(header, count * size, threadCategory);
+}
+
+}  // namespace
+
+CURLcode GlobalInit(long flags, const char** error) {  // NOLINT(runtime/int)
+  static std::once_flag modeFlag;
+
+  std::call_once(modeFlag, []() {
+    const char* value = std::getenv("NODE_LIBCURL_TRACK_MEMORY");
+    enabled.store(value && *value && std::strcmp(value, "0") != 0 &&
+                      std::strcmp(value, "false") != 0,
+                  std::memory_order_relaxed);
+
+    // set only once, as the tracked functions may already be running on other threads
+    // on the next calls. Selected always returns the same allocator.
+    if (const Allocator::Functions* allocator = Allocator::Selected(nullptr)) {
+      backend = allocator;
+    }
+  });
+
+  const Allocator::Functions* allocator = Allocator::Selected(error);
+  if (!allocator) {
+    return CURLE_FAILED_INIT;
+  }
+
+  // libcurl only uses the functions given on the first call, the others just add a reference
+  if (IsEnabled()) {
+    return curl_global_init_mem(flags, TrackedMalloc, TrackedFree, TrackedRealloc, TrackedStrdup,
+                                TrackedCalloc);
+  }
+
+  if (allocator != &Allocator::System()) {
+    return curl_global_init_mem(flags, allocator->malloc, allocator->free, allocator->realloc,
+                                allocator->strdup, allocator->calloc);
+  }
+
+  return curl_global_init(flags);
+}
+
+int64_t ThreadTotal() noexcept {
+  int64_t total = 0;
+
+  for (size_t i = 0; i < kCategoryCount; i++) {
+    total += ThreadBytes(static_cast<Category>(i));
+  }
+
+  return total;
+}
+
+int64_t ThreadBytes(Category category) noexcept {
+  if (!threadCounters) return 0;
+
+  return threadCounters->bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+Scope::Scope(Category category) noexcept : previous(threadCategory), active(IsEnabled()) {
+  if (this->active) threadCategory = category;
+}
+
+Scope::~Scope() {
+  if (this->active) threadCategory = this->previous;
+}
+
+}  // namespace NodeLibcurl::MemoryTracker
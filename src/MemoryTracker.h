@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <curl/curl.h>
+#include <napi.h>
+
+#include <atomic>
+#include <cstdint>
+
+// Optional accounting of the memory allocated by libcurl, enabled by setting the
+// NODE_LIBCURL_TRACK_MEMORY environment variable before the addon is loaded for the first time.
+//
+// When enabled, libcurl is initialized with curl_global_init_mem and allocation functions that
+// prefix each block with its size, its category, and the counters of the thread that allocated it.
+// Each Node.js environment runs on its own thread, so the counters of a thread are the memory
+// libcurl holds for the environment running on it, which is reported to V8 instead of the fixed
+// guess per handle used otherwise.
+//
+// The category of an allocation is set by the addon around its calls into libcurl with a Scope,
+// so for example everything allocated while running a transfer, like the connection cache, TLS
+// contexts and buffers, is accounted as Transfers.
+namespace NodeLibcurl::MemoryTracker {
+
+enum class Category : uint8_t {
+  Other = 0,
+  // creating, duplicating, resetting and closing handles
+  Handles = 1,
+  // setting options
+  Options = 2,
+  // running transfers, connections, TLS and buffers
+  Transfers = 3,
+  Count,
+};
+
+extern std::atomic<bool> enabled;
+
+inline bool IsEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+// Calls curl_global_init, or curl_global_init_mem with the tracking allocator if
+// NODE_LIBCURL_TRACK_MEMORY is set, and/or with the allocator selected by Allocator::Selected.
+// Only the first call in the process decides the mode.
+// If the allocator could not be selected, error is set to the reason, and CURLE_FAILED_INIT
+// is returned.
+CURLcode GlobalInit(long flags, const char** error);  // NOLINT(runtime/int)
+
+// Live bytes allocated by libcurl from the current thread, in total and by category.
+int64_t ThreadTotal() noexcept;
+int64_t ThreadBytes(Category category) noexcept;
+
+// Sets the category of the allocations done on the current thread while it is alive.
+class Scope {
+ public:
+  explicit Scope(Category category) noexcept;
+  ~Scope();
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  Category previous;
+  bool active;
+};
+
+}  // namespace NodeLibcurl::MemoryTracker
@@ -21,10 +21,14 @@
 #include "Easy.h"
 #include "Http2PushFrameHeaders.h"
 #include "LocaleGuard.h"
+#include "MemoryTracker.h"
 #include "Multi.h"
+#include "Probes.h"
+#include "Trace.h"
 #include "js_native_api.h"
 #include "napi.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -35,13 +39,15 @@
 
 namespace NodeLibcurl {
 
-std::atomic<uint64_t> Multi::nextId = 0;
+// 0 is left for trace records that are not from a handle, see Trace::Record
+std::atomic<uint64_t> Multi::nextId = 1;
 
 // Constructor
 Multi::Multi(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Multi>(info), id(nextId++) {
   NODE_LIBCURL_DEBUG_LOG(this, "Multi::Constructor", "");
   Napi::Env env = info.Env();
   auto curl = env.GetInstanceData<Curl>();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
 
 #if NODE_LIBCURL_VER_GE(8, 17, 0)
   bool shouldUseNotificationsApi = true;
@@ -161,8 +167,17 @@ void Multi::Dispose() {
   this->callbacks.clear();
   this->cbOnMessage.Reset();
 
+  // curl_multi_cleanup leaves the handles still added to it on their own
+  for (Easy* easy : this->handles) {
+    easy->isInsideMultiHandle = false;
+    easy->multi = nullptr;
+  }
+  this->handles.clear();
+  this->pendingCancellations.clear();
+
   // Clean up multi handle
   if (this->mh) {
+    MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
     CURLMcode code = curl_multi_cleanup(this->mh);
     assert(code == CURLM_OK);
     this->mh = nullptr;
@@ -200,6 +215,7 @@ Napi::Function Multi::Init(Napi::Env env, Napi::Object exports) {
 
 Napi::Value Multi::SetOpt(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Options);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Multi handle is closed", CURLM_BAD_HANDLE);
@@ -297,6 +313,7 @@ Napi::Value Multi::SetOpt(const Napi::CallbackInfo& info) {
 Napi::Value Multi::AddHandle(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   auto curl = env.GetInstanceData<Curl>();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Multi handle is closed", CURLM_BAD_HANDLE);
@@ -323,9 +340,14 @@ Napi::Value Multi::AddHandle(const Napi::CallbackInfo& info) {
   }
 
   NODE_LIBCURL_DEBUG_LOG(this, "Multi::AddHandle", "adding handle " + std::to_string(easy->id));
+  NODE_LIBCURL_TRACE(MultiAddHandle, this->id, easy->id, -1, 0);
+  NODE_LIBCURL_PROBE2(multi__add__handle, this->id, easy->id);
 
-  // reset callback error in case it is set
-  easy->callbackError.Reset();
+  // reset callback error in case it is set, unless it is the reason of a cancellation
+  if (!easy->isCancelled) {
+    easy->callbackError.Reset();
+  }
+  easy->OnTransferStart();
 
   // Check comment on node_libcurl.cc
   LocaleGuard localeGuard;
@@ -335,8 +357,12 @@ Napi::Value Multi::AddHandle(const Napi::CallbackInfo& info) {
     throw CurlError::New(env, "Could not add easy handle to the multi handle.", code, true);
   }
 
-  ++this->amountOfHandles;
-  easy->isInsideMultiHandle = true;
+  this->OnHandleAdded(easy);
+
+  // cancelled before it was added
+  if (easy->isCancelled) {
+    this->CancelHandle(easy);
+  }
 
   return Napi::Number::New(env, static_cast<int>(code));
 }
@@ -344,6 +370,7 @@ Napi::Value Multi::AddHandle(const Napi::CallbackInfo& info) {
 Napi::Value Multi::RemoveHandle(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   auto curl = env.GetInstanceData<Curl>();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Multi handle is closed", CURLM_BAD_HANDLE);
@@ -367,6 +394,8 @@ Napi::Value Multi::RemoveHandle(const Napi::CallbackInfo& info) {
 
   NODE_LIBCURL_DEBUG_LOG(this, "Multi::RemoveHandle",
                          "removing handle " + std::to_string(easy->id));
+  NODE_LIBCURL_TRACE(MultiRemoveHandle, this->id, easy->id, -1, 0);
+  NODE_LIBCURL_PROBE2(multi__remove__handle, this->id, easy->id);
 
   CURLMcode code = curl_multi_remove_handle(this->mh, easy->ch);
 
@@ -374,8 +403,22 @@ Napi::Value Multi::RemoveHandle(const Napi::CallbackInfo& info) {
     throw CurlError::New(env, "Could not remove easy handle from multi handle.", code, true);
   }
 
-  --this->amountOfHandles;
-  easy->isInsideMultiHandle = false;
+  if (easy->isInsideMultiHandle) {
+    this->OnHandleRemoved(easy);
+
+    // the promise returned by perform would never settle otherwise
+    auto promiseIt = this->handlePromiseMap.find(easy->ch);
+    if (promiseIt != this->handlePromiseMap.end()) {
+      easy->OnTransferEnd(CURLE_ABORTED_BY_CALLBACK);
+
+      auto deferred = promiseIt->second;
+      NODE_LIBCURL_PROBE3(multi__promise__settle, this->id, easy->id, CURLE_ABORTED_BY_CALLBACK);
+      this->handlePromiseMap.erase(promiseIt);
+      deferred->Reject(CurlError::New(env, "Easy handle was removed from the multi handle",
+                                      CURLE_ABORTED_BY_CALLBACK)
+                           .Value());
+    }
+  }
 
   return Napi::Number::New(env, static_cast<int>(code));
 }
@@ -383,6 +426,7 @@ Napi::Value Multi::RemoveHandle(const Napi::CallbackInfo& info) {
 Napi::Value Multi::Perform(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   auto curl = env.GetInstanceData<Curl>();
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Multi handle is closed", CURLM_BAD_HANDLE);
@@ -413,8 +457,11 @@ Napi::Value Multi::Perform(const Napi::CallbackInfo& info) {
   // Create deferred promise
   auto deferred = Napi::Promise::Deferred::New(env);
 
-  // reset callback error in case it is set
-  easy->callbackError.Reset();
+  // reset callback error in case it is set, unless it is the reason of a cancellation
+  if (!easy->isCancelled) {
+    easy->callbackError.Reset();
+  }
+  easy->OnTransferStart();
 
   // Check comment on node_libcurl.cc
   LocaleGuard localeGuard;
@@ -424,14 +471,18 @@ Napi::Value Multi::Perform(const Napi::CallbackInfo& info) {
     throw CurlError::New(env, "Could not add easy handle to the multi handle.", code, true);
   }
 
-  ++this->amountOfHandles;
-  easy->isInsideMultiHandle = true;
+  this->OnHandleAdded(easy);
 
   // Store the deferred promise for this handle
+  auto promise = deferred.Promise();
   this->handlePromiseMap[easy->ch] = std::make_shared<Napi::Promise::Deferred>(std::move(deferred));
 
-  // Return the promise
-  return this->handlePromiseMap[easy->ch]->Promise();
+  // cancelled before it was added, this rejects the promise right away
+  if (easy->isCancelled) {
+    this->CancelHandle(easy);
+  }
+
+  return promise;
 }
 
 Napi::Value Multi::OnMessage(const Napi::CallbackInfo& info) {
@@ -508,10 +559,15 @@ void Multi::ProcessMessages() {
   NODE_LIBCURL_DEBUG_LOG(this, "Multi::ProcessMessages", "isOpen: " + std::to_string(this->isOpen));
   if (!this->isOpen) return;
 
+  Trace::Span span(Trace::Event::MultiProcessMessages, this->id);
+
   int msgsLeft = 0;
   CURLMsg* msg = nullptr;
 
+  NODE_LIBCURL_PROBE1(multi__messages__start, this->id);
+
   while (this->isOpen && (msg = curl_multi_info_read(this->mh, &msgsLeft))) {
+    ++span.value;
     NODE_LIBCURL_DEBUG_LOG(
         this, "Multi::ProcessMessages",
         "msg->msg: " + std::to_string(msg->msg) + " isOpen: " + std::to_string(this->isOpen));
@@ -522,6 +578,79 @@ void Multi::ProcessMessages() {
       this->CallOnMessageCallback(easy, result);
     }
   }
+
+  NODE_LIBCURL_PROBE2(multi__messages__done, this->id, span.value);
+}
+
+void Multi::CancelHandle(Easy* easy) {
+  if (!this->isOpen || !easy->isInsideMultiHandle) return;
+
+  NODE_LIBCURL_DEBUG_LOG(this, "Multi::CancelHandle",
+                         "cancelling handle " + std::to_string(easy->id));
+  NODE_LIBCURL_TRACE(MultiCancelHandle, this->id, easy->id, -1, 0);
+
+  CURLMcode code = curl_multi_remove_handle(this->mh, easy->ch);
+
+  if (code == CURLM_RECURSIVE_API_CALL) {
+    // inside a libcurl callback, the callbacks of the handle abort it until it can be removed.
+    // The timer forces a call to curl_multi_socket_action on the next iteration of the loop,
+    // which then processes the queue.
+    this->pendingCancellations.push_back(easy);
+    uv_timer_start(&this->timeout, Multi::OnTimeout, 0, 0);
+    return;
+  }
+
+  if (code != CURLM_OK) return;
+
+  this->OnHandleRemoved(easy);
+
+  if (easy->isTransferRunning) {
+    this->CallOnMessageCallback(easy->ch, CURLE_ABORTED_BY_CALLBACK);
+  } else {
+    // it had already finished, so there is nothing left to cancel
+    easy->isCancelled = false;
+    easy->callbackError.Reset();
+  }
+}
+
+void Multi::ProcessPendingCancellations() {
+  if (this->pendingCancellations.empty()) return;
+
+  std::vector<Easy*> cancellations;
+  cancellations.swap(this->pendingCancellations);
+
+  for (Easy* easy : cancellations) {
+    // it may have been removed, or have finished and been added again, in the meantime
+    if (this->handles.count(easy) && (easy->isCancelled || !easy->isTransferRunning)) {
+      this->CancelHandle(easy);
+    }
+  }
+}
+
+void Multi::DetachHandle(Easy* easy) {
+  if (this->isOpen) {
+    curl_multi_remove_handle(this->mh, easy->ch);
+    this->handlePromiseMap.erase(easy->ch);
+  }
+
+  this->OnHandleRemoved(easy);
+
+  auto& pending = this->pendingCancellations;
+  pending.erase(std::remove(pending.begin(), pending.end(), easy), pending.end());
+}
+
+void Multi::OnHandleAdded(Easy* easy) {
+  ++this->amountOfHandles;
+  easy->isInsideMultiHandle = true;
+  easy->multi = this;
+  this->handles.insert(easy);
+}
+
+void Multi::OnHandleRemoved(Easy* easy) {
+  --this->amountOfHandles;
+  easy->isInsideMultiHandle = false;
+  easy->multi = nullptr;
+  this->handles.erase(easy);
 }
 
 void Multi::CallOnMessageCallback(CURL* easy, CURLcode handleCode) {
@@ -541,9 +670,15 @@ void Multi::CallOnMessageCallback(CURL* easy, CURLcode handleCode) {
   Easy* easyObj = reinterpret_cast<Easy*>(ptr);
 
   bool hasError = !easyObj->callbackError.IsEmpty();
+  bool isCancelled = easyObj->isCancelled;
 
-  // Determine the final status code
-  CURLcode statusCode = handleCode == CURLE_OK && hasError ? CURLE_ABORTED_BY_CALLBACK : handleCode;
+  // Determine the final status code, a cancelled transfer may have been aborted by any callback
+  bool isAborted = handleCode == CURLE_OK ? hasError : isCancelled;
+  CURLcode statusCode = isAborted ? CURLE_ABORTED_BY_CALLBACK : handleCode;
+
+  easyObj->OnTransferEnd(statusCode);
+  NODE_LIBCURL_TRACE(MultiTransferDone, this->id, easyObj->id, -1, statusCode);
+  NODE_LIBCURL_PROBE3(multi__transfer__done, this->id, easyObj->id, statusCode);
 
   // Handle promise-based perform() if exists
   auto promiseIt = this->handlePromiseMap.find(easy);
@@ -553,16 +688,21 @@ void Multi::CallOnMessageCallback(CURL* easy, CURLcode handleCode) {
         "resolving/rejecting promise for handle, statusCode: " + std::to_string(statusCode));
 
     auto deferred = promiseIt->second;
+    NODE_LIBCURL_PROBE3(multi__promise__settle, this->id, easyObj->id, statusCode);
 
     if (statusCode != CURLE_OK || hasError) {
       // Reject the promise with Error
       if (hasError) {
-        Napi::Error error =
-            CurlError::New(env, "Request was aborted by a callback", CURLE_ABORTED_BY_CALLBACK);
+        Napi::Error error = CurlError::New(
+            env, isCancelled ? "Request was cancelled" : "Request was aborted by a callback",
+            CURLE_ABORTED_BY_CALLBACK);
 
         auto errorValue = error.Value();
         errorValue.Set("cause", easyObj->callbackError.Value());
         deferred->Reject(errorValue);
+      } else if (isCancelled) {
+        auto error = CurlError::New(env, "Request was cancelled", CURLE_ABORTED_BY_CALLBACK);
+        deferred->Reject(error.Value());
       } else {
         auto error = CurlError::New(env, "Request failed", statusCode, true);
         deferred->Reject(error.Value());
@@ -577,6 +717,9 @@ void Multi::CallOnMessageCallback(CURL* easy, CURLcode handleCode) {
     return;
   }
 
+  // handles cancelled without a callback set
+  if (this->cbOnMessage.IsEmpty()) return;
+
   Napi::Function callback = this->cbOnMessage.Value();
 
   // Create arguments: error (null or Error object), Easy instance
@@ -672,11 +815,22 @@ void Multi::DestroyCurlSocketContext(CurlSocketContext* ctx) {
   }
 }
 
+// only called while the trace is enabled, the id of the Easy handle is not otherwise needed there
+static uint64_t TraceHandleId(CURL* easy) {
+  char* ptr = nullptr;
+  if (!easy || curl_easy_getinfo(easy, CURLINFO_PRIVATE, &ptr) != CURLE_OK || !ptr) return 0;
+
+  return reinterpret_cast<Easy*>(ptr)->id;
+}
+
 // libcurl callback implementations
 int Multi::HandleSocket(CURL* easy, curl_socket_t s, int action, void* userp, void* socketp) {
   CurlSocketContext* ctx = nullptr;
   Multi* obj = static_cast<Multi*>(userp);
 
+  NODE_LIBCURL_TRACE(MultiSocketAction, obj->id, TraceHandleId(easy), s, action);
+  NODE_LIBCURL_PROBE3(multi__socket__action, obj->id, s, action);
+
   if (action == CURL_POLL_IN || action == CURL_POLL_OUT || action == CURL_POLL_INOUT ||
       action == CURL_POLL_NONE) {
     // create ctx if it doesn't exists and assign it to the current socket,
@@ -735,6 +889,9 @@ int Multi::HandleTimeout(CURLM* multi,
     return 0;
   }
 
+  NODE_LIBCURL_TRACE(MultiTimerSet, obj->id, 0, -1, timeoutMs);
+  NODE_LIBCURL_PROBE2(multi__timer__set, obj->id, timeoutMs);
+
   if (timeoutMs < 0) {
     int uvStop = uv_timer_stop(&obj->timeout);
     return uvStop;
@@ -798,9 +955,8 @@ int Multi::CbPushFunction(CURL* parent, CURL* child, size_t numberOfHeaders,
     });
 
     Napi::Function callback = it->second.Value();
-    // TODO(jonathan, migration): capture this when perform is called or similar (either on Easy or
-    // Multi)
-    Napi::AsyncContext asyncContext(env, "Multi::CbPushFunction");
+    // the push belongs to the transfer of the parent handle
+    auto asyncContext = parentEasyObj->GetCallbackAsyncContext("Multi::CbPushFunction");
 
     Napi::Value returnValueCallback = callback.MakeCallback(obj->Value(),
                                                             {
@@ -808,7 +964,7 @@ int Multi::CbPushFunction(CURL* parent, CURL* child, size_t numberOfHeaders,
                                                                 childEasyJsObj,
                                                                 http2PushFrameJsObj,
                                                             },
-                                                            asyncContext);
+                                                            *asyncContext);
 
     if (!returnValueCallback.IsEmpty() && returnValueCallback.IsNumber()) {
       returnValue = returnValueCallback.As<Napi::Number>().Int32Value();
@@ -841,6 +997,9 @@ UV_TIMER_CB(Multi::OnTimeout) {
   Multi* obj = static_cast<Multi*>(timer->data);
 
   NODE_LIBCURL_DEBUG_LOG(obj, "Multi::OnTimeout", "");
+  Trace::Span span(Trace::Event::MultiOnTimeout, obj->id);
+  NODE_LIBCURL_PROBE1(multi__timeout__start, obj->id);
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
 
   // Check comment on node_libcurl.cc
   LocaleGuard localeGuard;
@@ -854,6 +1013,14 @@ UV_TIMER_CB(Multi::OnTimeout) {
   if (!obj->useNotificationsApi) {
     obj->ProcessMessages();
   }
+
+  obj->ProcessPendingCancellations();
+
+  if (MemoryTracker::IsEnabled()) {
+    obj->Env().GetInstanceData<Curl>()->SyncTrackedMemory();
+  }
+
+  NODE_LIBCURL_PROBE1(multi__timeout__done, obj->id);
 }
 
 void Multi::OnSocket(uv_poll_t* handle, int status, int events) {
@@ -866,8 +1033,13 @@ void Multi::OnSocket(uv_poll_t* handle, int status, int events) {
   if (events & UV_WRITABLE) flags |= CURL_CSELECT_OUT;
 
   Multi::CurlSocketContext* ctx = static_cast<Multi::CurlSocketContext*>(handle->data);
+  Multi* multi = ctx->multi;
 
   NODE_LIBCURL_DEBUG_LOG(ctx->multi, "Multi::OnSocket", "events: " + std::to_string(events));
+  Trace::Span span(Trace::Event::MultiOnSocket, multi->id, 0, ctx->sockfd);
+  span.value = events;
+  NODE_LIBCURL_PROBE3(multi__socket__start, multi->id, ctx->sockfd, events);
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Transfers);
 
   // Check comment on node_libcurl.cc
   LocaleGuard localeGuard;
@@ -885,9 +1057,17 @@ void Multi::OnSocket(uv_poll_t* handle, int status, int events) {
   assert(code == CURLM_OK && "curl_multi_socket_action failed");
 
   // When notifications are enabled, libcurl will call our NotifyCallback when needed
-  if (!ctx->multi->useNotificationsApi) {
-    ctx->multi->ProcessMessages();
+  if (!multi->useNotificationsApi) {
+    multi->ProcessMessages();
   }
+
+  multi->ProcessPendingCancellations();
+
+  if (MemoryTracker::IsEnabled()) {
+    multi->Env().GetInstanceData<Curl>()->SyncTrackedMemory();
+  }
+
+  NODE_LIBCURL_PROBE2(multi__socket__done, multi->id, events);
 }
 
 }  // namespace NodeLibcurl
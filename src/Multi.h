@@ -14,13 +14,21 @@
 #include <map>
 #include <memory>
 #include <napi.h>
+#include <set>
 #include <uv.h>
+#include <vector>
 
 namespace NodeLibcurl {
 
 // Forward declaration
 class Easy;
 
+#ifdef NODE_LIBCURL_BENCHMARKS
+namespace Benchmarks {
+class MultiAccess;
+}  // namespace Benchmarks
+#endif
+
 class Multi : public Napi::ObjectWrap<Multi> {
  public:
   // Constructor and destructor
@@ -46,6 +54,12 @@ class Multi : public Napi::ObjectWrap<Multi> {
   // Debug support
   uint64_t GetDebugId() const { return id; }
 
+  // Removes the handle, failing its transfer with CURLE_ABORTED_BY_CALLBACK, see Easy#cancel.
+  // When called from inside a libcurl callback the removal is queued until libcurl returns.
+  void CancelHandle(Easy* easy);
+  // Called when a handle that is still inside this Multi is disposed
+  void DetachHandle(Easy* easy);
+
   // Public members
   CURLM* mh;
   bool isOpen = true;
@@ -65,7 +79,10 @@ class Multi : public Napi::ObjectWrap<Multi> {
   void CloseTimerAsync();
   void Dispose();
   void ProcessMessages();
+  void ProcessPendingCancellations();
   void CallOnMessageCallback(CURL* easy, CURLcode statusCode);
+  void OnHandleAdded(Easy* easy);
+  void OnHandleRemoved(Easy* easy);
 
   // Socket context helpers
   static CurlSocketContext* CreateCurlSocketContext(curl_socket_t sockfd, Multi* multi) noexcept;
@@ -79,6 +96,11 @@ class Multi : public Napi::ObjectWrap<Multi> {
   // Promise-based perform tracking
   std::map<CURL*, std::shared_ptr<Napi::Promise::Deferred>> handlePromiseMap;
 
+  // Handles currently added, so they can be detached when this is closed
+  std::set<Easy*> handles;
+  // Cancellations requested from inside libcurl callbacks, see CancelHandle
+  std::vector<Easy*> pendingCancellations;
+
   // Timer for timeout handling
   uv_timer_t timeout;
   bool timerClosed = false;
@@ -112,6 +134,10 @@ class Multi : public Napi::ObjectWrap<Multi> {
 
   // Debug logging removed - now using NODE_LIBCURL_DEBUG_LOG macros
 
+#ifdef NODE_LIBCURL_BENCHMARKS
+  friend class Benchmarks::MultiAccess;
+#endif
+
   // Prevent copying
   Multi(const Multi& that) = delete;
   Multi& operator=(const Multi& that) = delete;
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+// USDT (SystemTap / bpftrace) static probes, only compiled in when building with
+// node_libcurl_usdt=true on Linux, which requires <sys/sdt.h> (systemtap-sdt-dev).
+//
+// Each probe is a single nop in the code, and an ELF note with the location and arguments,
+// until a tracer attaches to it. The arguments must be cheap to compute, as they are computed
+// even when nothing is attached.
+//
+// The probes are listed on DEBUGGING.md, all of them are in the node_libcurl provider:
+//  bpftrace -l 'usdt:./lib/binding/node_libcurl.node:node_libcurl:*'
+#ifdef NODE_LIBCURL_USDT
+
+#include <sys/sdt.h>
+
+#define NODE_LIBCURL_PROBE1(name, a) DTRACE_PROBE1(node_libcurl, name, a)
+#define NODE_LIBCURL_PROBE2(name, a, b) DTRACE_PROBE2(node_libcurl, name, a, b)
+#define NODE_LIBCURL_PROBE3(name, a, b, c) DTRACE_PROBE3(node_libcurl, name, a, b, c)
+#define NODE_LIBCURL_PROBE4(name, a, b, c, d) DTRACE_PROBE4(node_libcurl, name, a, b, c, d)
+
+#else
+
+#define NODE_LIBCURL_PROBE1(name, a) \
+  do {                               \
+  } while (0)
+#define NODE_LIBCURL_PROBE2(name, a, b) \
+  do {                                  \
+  } while (0)
+#define NODE_LIBCURL_PROBE3(name, a, b, c) \
+  do {                                     \
+  } while (0)
+#define NODE_LIBCURL_PROBE4(name, a, b, c, d) \
+  do {                                        \
+  } while (0)
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "Curl.h"
 #include "CurlError.h"
+#include "MemoryTracker.h"
 
 #include <cassert>
 #include <iostream>
@@ -37,6 +38,7 @@ Share::Share(const Napi::CallbackInfo& info)
     throw Napi::TypeError::New(env, "You must use \"new\" to instantiate this object.");
   }
 
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
   this->sh = curl_share_init();
 
   if (!this->sh) {
@@ -60,6 +62,7 @@ void Share::Dispose() {
 
   this->isOpen = false;
 
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Handles);
   CURLSHcode code = curl_share_cleanup(this->sh);
   assert(code == CURLSHE_OK);
 
@@ -86,6 +89,7 @@ Napi::Function Share::Init(Napi::Env env, Napi::Object exports) {
 Napi::Value Share::SetOpt(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
+  MemoryTracker::Scope memoryScope(MemoryTracker::Category::Options);
 
   if (!this->isOpen) {
     throw CurlError::New(env, "Share handle is closed.", CURLSHE_INVALID);
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace NodeLibcurl::Trace {
+
+std::atomic<bool> enabled{false};
+
+// capacity of the rings, the ring of each thread is (re)allocated lazily on its next write
+static std::atomic<uint32_t> capacity{kDefaultCapacity};
+
+// 1M records, 48 MiB per thread
+static constexpr uint32_t kMaxCapacity = 1 << 20;
+
+namespace {
+
+struct Ring {
+  std::unique_ptr<Record[]> records;
+  uint32_t capacity = 0;
+  // next record to be written, and how many of the records before it were not drained yet
+  uint32_t head = 0;
+  uint32_t count = 0;
+  uint64_t dropped = 0;
+};
+
+// Each thread (the main one and each worker) only writes to and drains its own ring,
+// so they need no synchronization.
+thread_local Ring ring;
+
+}  // namespace
+
+void Write(Event event, uint64_t multiId, uint64_t handleId, int64_t socket, int32_t value,
+           uint64_t timestamp, uint64_t duration) noexcept {
+  uint32_t wantedCapacity = capacity.load(std::memory_order_relaxed);
+
+  if (ring.capacity != wantedCapacity) {
+    ring.records.reset(new (std::nothrow) Record[wantedCapacity]);
+    ring.capacity = ring.records ? wantedCapacity : 0;
+    ring.head = 0;
+    ring.count = 0;
+
+    if (!ring.records) return;
+  }
+
+  Record& record = ring.records[ring.head];
+  record.timestamp = timestamp;
+  record.duration = duration;
+  record.multiId = multiId;
+  record.handleId = handleId;
+  record.socket = socket;
+  record.value = value;
+  record.event = static_cast<uint16_t>(event);
+  record.reserved = 0;
+
+  ring.head = (ring.head + 1) % ring.capacity;
+
+  if (ring.count == ring.capacity) {
+    ++ring.dropped;
+  } else {
+    ++ring.count;
+  }
+}
+
+Napi::Value SetEnabled(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    throw Napi::TypeError::New(env, "Argument must be a boolean");
+  }
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      throw Napi::TypeError::New(env, "The capacity must be a number");
+    }
+
+    int64_t newCapacity = info[1].As<Napi::Number>().Int64Value();
+
+    if (newCapacity < 1 || newCapacity > kMaxCapacity) {
+      throw Napi::RangeError::New(
+          env, "The capacity must be between 1 and " + std::to_string(kMaxCapacity));
+    }
+
+    capacity.store(static_cast<uint32_t>(newCapacity), std::memory_order_relaxed);
+  }
+
+  enabled.store(info[0].As<Napi::Boolean>().Value(), std::memory_order_relaxed);
+
+  return env.Undefined();
+}
+
+Napi::Value GetEnabled(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), IsEnabled());
+}
+
+Napi::Value Drain(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Napi::ArrayBuffer records = Napi::ArrayBuffer::New(env, ring.count * sizeof(Record));
+  auto data = static_cast<uint8_t*>(records.Data());
+
+  // the ring wraps around at most once, copy the records in two runs
+  uint32_t first = (ring.head + ring.capacity - ring.count) % (ring.capacity ? ring.capacity : 1);
+  uint32_t firstRun = std::min(ring.count, ring.capacity - first);
+
+  if (firstRun > 0) {
+    std::memcpy(data, ring.records.get() + first, firstRun * sizeof(Record));
+  }
+  if (ring.count > firstRun) {
+    std::memcpy(data + firstRun * sizeof(Record), ring.records.get(),
+                (ring.count - firstRun) * sizeof(Record));
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("dropped", Napi::Number::New(env, static_cast<double>(ring.dropped)));
+  result.Set("records", records);
+
+  ring.count = 0;
+  ring.dropped = 0;
+
+  return result;
+}
+
+}  // namespace NodeLibcurl::Trace
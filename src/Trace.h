@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <napi.h>
+#include <uv.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Internal trace of what the Multi and Easy handles are doing, always compiled in.
+//
+// Unlike NODE_LIBCURL_DEBUG_LOG, which only exists in debug builds, this can be enabled at runtime
+// in production builds. While disabled each trace point costs a single relaxed load of an atomic
+// flag. While enabled each trace point writes a fixed size binary record into a ring buffer of
+// the current thread, no allocation and no formatting happens on the hot path.
+//
+// Keep the events and the record layout in sync with lib/enum/TraceEvent.ts and lib/Curl.ts
+namespace NodeLibcurl::Trace {
+
+enum class Event : uint16_t {
+  MultiAddHandle = 1,
+  MultiRemoveHandle = 2,
+  MultiCancelHandle = 3,
+  // value is the CURL_POLL_* action
+  MultiSocketAction = 4,
+  // value is the timeout in ms, -1 when the timer is stopped
+  MultiTimerSet = 5,
+  MultiOnTimeout = 6,
+  // value is the UV_READABLE / UV_WRITABLE events
+  MultiOnSocket = 7,
+  // value is the number of messages processed
+  MultiProcessMessages = 8,
+  // value is the CURLcode of the finished transfer
+  MultiTransferDone = 9,
+  // value is the CURLcode returned by curl_easy_perform
+  EasyPerform = 10,
+  // value is the CallbackSlot of the JS callback called
+  EasyCallback = 11,
+  EasyTransferStart = 12,
+  // value is the CURLcode of the transfer
+  EasyTransferEnd = 13,
+  // value is the TransferTime, timestamp is when the transfer started, and duration is the
+  // time libcurl reports for it, from the start of the transfer
+  EasyTransferTime = 14,
+};
+
+// The CURLINFO_*_TIME_T values recorded at the end of each transfer
+enum class TransferTime : int32_t {
+  Queue = 0,
+  NameLookup = 1,
+  Connect = 2,
+  AppConnect = 3,
+  PreTransfer = 4,
+  StartTransfer = 5,
+  Total = 6,
+};
+
+// 48 bytes, the layout is read as is from JS.
+struct Record {
+  uint64_t timestamp;  // uv_hrtime() when the event started
+  uint64_t duration;   // ns, 0 for events that are not a span
+  uint64_t multiId;    // 0 if the event is not from a Multi handle, their ids start at 1
+  uint64_t handleId;   // 0 if the event is not from a specific Easy handle
+  int64_t socket;
+  int32_t value;
+  uint16_t event;
+  uint16_t reserved;
+};
+
+static_assert(sizeof(Record) == 48, "Trace::Record layout is read from JS");
+
+constexpr uint32_t kDefaultCapacity = 8192;
+
+extern std::atomic<bool> enabled;
+
+inline bool IsEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+void Write(Event event, uint64_t multiId, uint64_t handleId, int64_t socket, int32_t value,
+           uint64_t timestamp, uint64_t duration) noexcept;
+
+// Records the time between its construction and destruction, if the trace was enabled when
+// it was constructed.
+class Span {
+ public:
+  Span(Event event, uint64_t multiId, uint64_t handleId = 0, int64_t socket = -1,
+       int32_t value = 0) noexcept
+      : value(value),
+        event(event),
+        multiId(multiId),
+        handleId(handleId),
+        socket(socket),
+        start(IsEnabled() ? uv_hrtime() : 0) {}
+
+  ~Span() {
+    if (this->start != 0) {
+      Write(this->event, this->multiId, this->handleId, this->socket, this->value, this->start,
+            uv_hrtime() - this->start);
+    }
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+  int32_t value = 0;
+
+ private:
+  Event event;
+  uint64_t multiId;
+  uint64_t handleId;
+  int64_t socket;
+  uint64_t start;
+};
+
+// JS bindings, exported on the native Curl object.
+// setTraceEnabled(enabled, capacity?)
+Napi::Value SetEnabled(const Napi::CallbackInfo& info);
+// isTraceEnabled()
+Napi::Value GetEnabled(const Napi::CallbackInfo& info);
+// drainTrace(), returns { dropped, records } with the records of the calling thread only,
+// records is an ArrayBuffer of Record structs, from oldest to newest.
+Napi::Value Drain(const Napi::CallbackInfo& info);
+
+}  // namespace NodeLibcurl::Trace
+
+#define NODE_LIBCURL_TRACE(event, multiId, handleId, socket, value)                               \
+  do {                                                                                            \
+    if (NodeLibcurl::Trace::IsEnabled()) [[unlikely]] {                                           \
+      NodeLibcurl::Trace::Write(NodeLibcurl::Trace::Event::event, (multiId), (handleId), (socket), \
+                                static_cast<int32_t>(value), uv_hrtime(), 0);                     \
+    }                                                                                             \
+  } while (0)
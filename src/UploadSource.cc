@@ -0,0 +1,476 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "UploadSource.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NodeLibcurl {
+
+BufferListUploadSource::BufferListUploadSource(std::vector<Segment> segments,
+                                               std::vector<Napi::ObjectReference> references)
+    : references(std::move(references)) {
+  curl_off_t end = 0;
+
+  // empty segments would only make the cursor logic harder
+  for (const Segment& segment : segments) {
+    if (segment.length == 0) continue;
+
+    end += static_cast<curl_off_t>(segment.length);
+    this->segments.push_back(segment);
+    this->segmentEnds.push_back(end);
+  }
+}
+
+size_t BufferListUploadSource::Read(char* ptr, size_t size) {
+  size_t copied = 0;
+
+  while (copied < size && this->segmentIndex < this->segments.size()) {
+    const Segment& segment = this->segments[this->segmentIndex];
+    size_t n = std::min(size - copied, segment.length - this->segmentOffset);
+
+    std::memcpy(ptr + copied, segment.data + this->segmentOffset, n);
+    copied += n;
+    this->segmentOffset += n;
+
+    if (this->segmentOffset == segment.length) {
+      this->segmentIndex++;
+      this->segmentOffset = 0;
+    }
+  }
+
+  this->position += static_cast<curl_off_t>(copied);
+
+  return copied;
+}
+
+int BufferListUploadSource::Seek(curl_off_t offset, int origin) {
+  curl_off_t target;
+
+  switch (origin) {
+    case SEEK_SET:
+      target = offset;
+      break;
+    case SEEK_CUR:
+      target = this->position + offset;
+      break;
+    case SEEK_END:
+      target = this->Size() + offset;
+      break;
+    default:
+      return CURL_SEEKFUNC_FAIL;
+  }
+
+  if (target < 0 || target > this->Size()) {
+    return CURL_SEEKFUNC_FAIL;
+  }
+
+  // first segment ending after the target, when target is the total size this is the end
+  auto it = std::upper_bound(this->segmentEnds.begin(), this->segmentEnds.end(), target);
+  this->segmentIndex = static_cast<size_t>(it - this->segmentEnds.begin());
+
+  curl_off_t segmentStart =
+      this->segmentIndex == 0 ? 0 : this->segmentEnds[this->segmentIndex - 1];
+  this->segmentOffset = static_cast<size_t>(target - segmentStart);
+  this->position = target;
+
+  return CURL_SEEKFUNC_OK;
+}
+
+curl_off_t BufferListUploadSource::Size() const {
+  return this->segmentEnds.empty() ? 0 : this->segmentEnds.back();
+}
+
+std::unique_ptr<UploadSource> BufferListUploadSource::Clone() const {
+  std::vector<Napi::ObjectReference> references;
+  references.reserve(this->references.size());
+  for (const Napi::ObjectReference& reference : this->references) {
+    references.push_back(Napi::Persistent(reference.Value()));
+  }
+
+  return std::make_unique<BufferListUploadSource>(this->segments, std::move(references));
+}
+
+FileReadAheadUploadSource::FileReadAheadUploadSource(uv_loop_t* loop, int32_t fd,
+                                                     curl_off_t offset,
+                                                     std::function<void()> onDataAvailable)
+    : state(std::make_shared<State>()) {
+  this->state->loop = loop;
+  this->state->fd = fd;
+  this->state->nextOffset = offset;
+  this->state->onDataAvailable = std::move(onDataAvailable);
+
+  IssueRead(this->state);
+}
+
+FileReadAheadUploadSource::~FileReadAheadUploadSource() {
+  // a pending read still holds the state, make sure it does not call back into a dead handle
+  this->state->generation++;
+  this->state->onDataAvailable = nullptr;
+}
+
+size_t FileReadAheadUploadSource::Read(char* ptr, size_t size) {
+  State& state = *this->state;
+
+  if (state.error < 0) {
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (state.ready.empty()) {
+    if (state.isEof) {
+      return 0;
+    }
+
+    IssueRead(this->state);
+    if (state.error < 0) {
+      return CURL_READFUNC_ABORT;
+    }
+
+    state.isWaiting = true;
+    return CURL_READFUNC_PAUSE;
+  }
+
+  size_t copied = 0;
+
+  while (copied < size && !state.ready.empty()) {
+    Chunk& chunk = state.ready.front();
+    size_t n = std::min(size - copied, chunk.length - chunk.cursor);
+
+    std::memcpy(ptr + copied, chunk.data.data() + chunk.cursor, n);
+    copied += n;
+    chunk.cursor += n;
+
+    if (chunk.cursor == chunk.length) {
+      state.spare.push_back(std::move(chunk.data));
+      state.ready.pop_front();
+    }
+  }
+
+  // keep the next block coming while libcurl sends this one
+  IssueRead(this->state);
+
+  return copied;
+}
+
+int FileReadAheadUploadSource::Seek(curl_off_t offset, int origin) {
+  // libcurl only seeks from the beginning
+  if (origin != SEEK_SET) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  if (offset < 0) {
+    return CURL_SEEKFUNC_FAIL;
+  }
+
+  State& state = *this->state;
+
+  state.generation++;
+  state.isReadPending = false;
+  state.isEof = false;
+  state.isWaiting = false;
+  state.error = 0;
+  state.nextOffset = offset;
+
+  for (Chunk& chunk : state.ready) {
+    state.spare.push_back(std::move(chunk.data));
+  }
+  state.ready.clear();
+
+  IssueRead(this->state);
+
+  return CURL_SEEKFUNC_OK;
+}
+
+curl_off_t FileReadAheadUploadSource::Size() const {
+  return -1;
+}
+
+std::unique_ptr<UploadSource> FileReadAheadUploadSource::Clone() const {
+  // duplicated handles create their own when they start reading
+  return nullptr;
+}
+
+void FileReadAheadUploadSource::IssueRead(const std::shared_ptr<State>& state) {
+  if (state->isReadPending || state->isEof || state->error < 0 ||
+      state->ready.size() >= kBlocksAhead) {
+    return;
+  }
+
+  auto request = new ReadRequest();
+  request->state = state;
+  request->generation = state->generation;
+
+  if (!state->spare.empty()) {
+    request->data = std::move(state->spare.back());
+    state->spare.pop_back();
+  } else {
+    request->data.resize(kBlockSize);
+  }
+
+  request->req.data = request;
+
+  uv_buf_t buf = uv_buf_init(request->data.data(), static_cast<unsigned int>(kBlockSize));
+  int result = uv_fs_read(state->loop, &request->req, state->fd, &buf, 1, state->nextOffset,
+                          FileReadAheadUploadSource::OnRead);
+
+  if (result < 0) {
+    state->error = result;
+    uv_fs_req_cleanup(&request->req);
+    delete request;
+    return;
+  }
+
+  state->isReadPending = true;
+}
+
+void FileReadAheadUploadSource::OnRead(uv_fs_t* req) {
+  std::unique_ptr<ReadRequest> request(static_cast<ReadRequest*>(req->data));
+  std::shared_ptr<State> state = request->state;
+  ssize_t result = req->result;
+
+  uv_fs_req_cleanup(req);
+
+  // the source was destroyed, or seeked, after this read was issued
+  if (request->generation != state->generation) {
+    return;
+  }
+
+  state->isReadPending = false;
+
+  if (result < 0) {
+    state->error = static_cast<int>(result);
+  } else if (result == 0) {
+    state->isEof = true;
+  } else {
+    if (state->nextOffset >= 0) {
+      state->nextOffset += result;
+    }
+
+    state->ready.push_back({std::move(request->data), static_cast<size_t>(result), 0});
+    IssueRead(state);
+  }
+
+  if (state->isWaiting && state->onDataAvailable) {
+    state->isWaiting = false;
+    // copy it, as this may end up destroying the source, and the function with it
+    auto onDataAvailable = state->onDataAvailable;
+    onDataAvailable();
+  }
+}
+
+#ifdef _WIN32
+static std::string GetLastErrorMessage() {
+  DWORD code = GetLastError();
+  char* message = nullptr;
+  DWORD length = FormatMessageA(
+      FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+      nullptr, code, 0, reinterpret_cast<char*>(&message), 0, nullptr);
+
+  std::string result = length ? std::string(message, length) : "Error " + std::to_string(code);
+  LocalFree(message);
+
+  // FormatMessage adds a line break at the end
+  while (!result.empty() && (result.back() == '\n' || result.back() == '\r')) {
+    result.pop_back();
+  }
+
+  return result;
+}
+#endif
+
+std::unique_ptr<MappedFileUploadSource> MappedFileUploadSource::Open(const std::string& path,
+                                                                     curl_off_t offset,
+                                                                     curl_off_t length,
+                                                                     std::string* error) {
+  auto mapping = std::make_shared<Mapping>();
+  uint64_t fileSize = 0;
+
+#ifdef _WIN32
+  int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring widePath(wideLength, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), wideLength);
+
+  HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    *error = GetLastErrorMessage();
+    return nullptr;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    *error = GetLastErrorMessage();
+    CloseHandle(file);
+    return nullptr;
+  }
+  fileSize = static_cast<uint64_t>(size.QuadPart);
+#else
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    *error = std::strerror(errno);
+    return nullptr;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == -1) {
+    *error = std::strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  fileSize = static_cast<uint64_t>(info.st_size);
+#endif
+
+  if (offset < 0 || static_cast<uint64_t>(offset) > fileSize) {
+    *error = "Offset is out of the bounds of the file.";
+  } else {
+    uint64_t available = fileSize - static_cast<uint64_t>(offset);
+    if (length < 0) {
+      length = static_cast<curl_off_t>(available);
+    }
+
+    if (static_cast<uint64_t>(length) > available) {
+      *error = "Length is out of the bounds of the file.";
+    }
+  }
+
+  // empty ranges cannot be mapped, there is also no need to
+  if (error->empty() && length > 0) {
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    uint64_t alignedOffset = static_cast<uint64_t>(offset) -
+                             static_cast<uint64_t>(offset) % systemInfo.dwAllocationGranularity;
+#else
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t alignedOffset =
+        static_cast<uint64_t>(offset) - static_cast<uint64_t>(offset) % pageSize;
+#endif
+    size_t mappedLength =
+        static_cast<size_t>(static_cast<uint64_t>(offset) - alignedOffset + length);
+
+#ifdef _WIN32
+    HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* address = nullptr;
+
+    if (fileMapping) {
+      address = MapViewOfFile(fileMapping, FILE_MAP_READ, static_cast<DWORD>(alignedOffset >> 32),
+                              static_cast<DWORD>(alignedOffset & 0xFFFFFFFF), mappedLength);
+    }
+
+    if (!address) {
+      *error = GetLastErrorMessage();
+    }
+
+    // the view keeps the mapping alive by itself
+    if (fileMapping) {
+      CloseHandle(fileMapping);
+    }
+#else
+    void* address = mmap(nullptr, mappedLength, PROT_READ, MAP_PRIVATE, fd,
+                         static_cast<off_t>(alignedOffset));
+
+    if (address == MAP_FAILED) {
+      *error = std::strerror(errno);
+      address = nullptr;
+    } else {
+      // a hint only, so failing is not an error
+      madvise(address, mappedLength, MADV_SEQUENTIAL);
+    }
+#endif
+
+    if (address) {
+      mapping->address = address;
+      mapping->mappedLength = mappedLength;
+      mapping->data =
+          static_cast<const char*>(address) + (static_cast<uint64_t>(offset) - alignedOffset);
+      mapping->length = static_cast<size_t>(length);
+    }
+  }
+
+#ifdef _WIN32
+  CloseHandle(file);
+#else
+  close(fd);
+#endif
+
+  if (!error->empty()) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<MappedFileUploadSource>(new MappedFileUploadSource(mapping));
+}
+
+MappedFileUploadSource::MappedFileUploadSource(std::shared_ptr<const Mapping> mapping)
+    : mapping(std::move(mapping)) {}
+
+MappedFileUploadSource::Mapping::~Mapping() {
+  if (!this->address) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(this->address);
+#else
+  munmap(this->address, this->mappedLength);
+#endif
+}
+
+size_t MappedFileUploadSource::Read(char* ptr, size_t size) {
+  size_t n = std::min(size, this->mapping->length - this->position);
+
+  if (n > 0) {
+    std::memcpy(ptr, this->mapping->data + this->position, n);
+    this->position += n;
+  }
+
+  return n;
+}
+
+int MappedFileUploadSource::Seek(curl_off_t offset, int origin) {
+  curl_off_t target;
+
+  switch (origin) {
+    case SEEK_SET:
+      target = offset;
+      break;
+    case SEEK_CUR:
+      target = static_cast<curl_off_t>(this->position) + offset;
+      break;
+    case SEEK_END:
+      target = this->Size() + offset;
+      break;
+    default:
+      return CURL_SEEKFUNC_FAIL;
+  }
+
+  if (target < 0 || target > this->Size()) {
+    return CURL_SEEKFUNC_FAIL;
+  }
+
+  this->position = static_cast<size_t>(target);
+
+  return CURL_SEEKFUNC_OK;
+}
+
+curl_off_t MappedFileUploadSource::Size() const {
+  return static_cast<curl_off_t>(this->mapping->length);
+}
+
+std::unique_ptr<UploadSource> MappedFileUploadSource::Clone() const {
+  return std::unique_ptr<MappedFileUploadSource>(new MappedFileUploadSource(this->mapping));
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <curl/curl.h>
+#include <napi.h>
+#include <uv.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Data to be uploaded that is served natively by Easy::ReadFunction and Easy::SeekFunction,
+// without calling into JS.
+class UploadSource {
+ public:
+  virtual ~UploadSource() = default;
+
+  // Same contract as CURLOPT_READFUNCTION, returns the number of bytes copied into ptr,
+  // 0 when there is nothing left to read, or one of the CURL_READFUNC_* values.
+  virtual size_t Read(char* ptr, size_t size) = 0;
+
+  // Same contract as CURLOPT_SEEKFUNCTION, returns one of the CURL_SEEKFUNC_* values.
+  virtual int Seek(curl_off_t offset, int origin) = 0;
+
+  // Total number of bytes to be uploaded
+  virtual curl_off_t Size() const = 0;
+
+  // Used by duplicated handles, the copy starts reading from the beginning.
+  virtual std::unique_ptr<UploadSource> Clone() const = 0;
+};
+
+// Serves a list of buffers as if they were a single one, like an iovec list.
+class BufferListUploadSource : public UploadSource {
+ public:
+  struct Segment {
+    const char* data;
+    size_t length;
+  };
+
+  // references keep the memory of the segments alive, they are not read directly.
+  BufferListUploadSource(std::vector<Segment> segments,
+                         std::vector<Napi::ObjectReference> references);
+
+  size_t Read(char* ptr, size_t size) override;
+  int Seek(curl_off_t offset, int origin) override;
+  curl_off_t Size() const override;
+  std::unique_ptr<UploadSource> Clone() const override;
+
+ private:
+  std::vector<Segment> segments;
+  // offset right after the end of each segment, used to find the segment when seeking
+  std::vector<curl_off_t> segmentEnds;
+  std::vector<Napi::ObjectReference> references;
+
+  size_t segmentIndex = 0;
+  size_t segmentOffset = 0;
+  curl_off_t position = 0;
+};
+
+// Reads a file descriptor on the libuv threadpool, one block ahead of what libcurl asked for,
+// instead of blocking the event loop with a synchronous read inside the READFUNCTION.
+//
+// When no data is ready yet, Read returns CURL_READFUNC_PAUSE, and onDataAvailable is called
+// once the pending read finishes, so the transfer can be unpaused. This only works when the
+// loop keeps running during the transfer, which means inside a Multi handle.
+class FileReadAheadUploadSource : public UploadSource {
+ public:
+  // offset -1 means reading from the current file position. The reads ahead move it too, so if
+  // the transfer stops before the end of the file, it is past what libcurl consumed, by up to
+  // kBlocksAhead blocks. Synchronous reads only move it by what libcurl asked for.
+  FileReadAheadUploadSource(uv_loop_t* loop, int32_t fd, curl_off_t offset,
+                            std::function<void()> onDataAvailable);
+  ~FileReadAheadUploadSource() override;
+
+  size_t Read(char* ptr, size_t size) override;
+  int Seek(curl_off_t offset, int origin) override;
+  curl_off_t Size() const override;
+  std::unique_ptr<UploadSource> Clone() const override;
+
+ private:
+  struct Chunk {
+    std::vector<char> data;
+    size_t length;
+    size_t cursor;
+  };
+
+  // Shared with the pending read request, which may finish after the source is gone.
+  struct State {
+    uv_loop_t* loop;
+    int32_t fd;
+    curl_off_t nextOffset;
+
+    std::deque<Chunk> ready;
+    std::vector<std::vector<char>> spare;
+
+    // bumped on seek, so the result of a read issued before it is discarded
+    uint64_t generation = 0;
+    bool isReadPending = false;
+    bool isEof = false;
+    bool isWaiting = false;
+    int error = 0;
+
+    std::function<void()> onDataAvailable;
+  };
+
+  struct ReadRequest {
+    uv_fs_t req;
+    std::shared_ptr<State> state;
+    std::vector<char> data;
+    uint64_t generation;
+  };
+
+  static constexpr size_t kBlockSize = 128 * 1024;
+  static constexpr size_t kBlocksAhead = 2;
+
+  static void IssueRead(const std::shared_ptr<State>& state);
+  static void OnRead(uv_fs_t* req);
+
+  std::shared_ptr<State> state;
+};
+
+// Serves a range of a file from a read only memory mapping, so reading and rewinding
+// are just a memcpy from the right position, instead of a syscall per chunk.
+class MappedFileUploadSource : public UploadSource {
+ public:
+  // length -1 means until the end of the file.
+  // Returns nullptr, setting error, if the file could not be mapped.
+  static std::unique_ptr<MappedFileUploadSource> Open(const std::string& path, curl_off_t offset,
+                                                      curl_off_t length, std::string* error);
+
+  size_t Read(char* ptr, size_t size) override;
+  int Seek(curl_off_t offset, int origin) override;
+  curl_off_t Size() const override;
+  std::unique_ptr<UploadSource> Clone() const override;
+
+ private:
+  // Shared with the sources of duplicated handles
+  struct Mapping {
+    void* address = nullptr;
+    size_t mappedLength = 0;
+    // start of the range requested, the mapping itself starts at a page boundary
+    const char* data = nullptr;
+    size_t length = 0;
+
+    ~Mapping();
+  };
+
+  explicit MappedFileUploadSource(std::shared_ptr<const Mapping> mapping);
+
+  std::shared_ptr<const Mapping> mapping;
+  size_t position = 0;
+};
+
+}  // namespace NodeLibcurl
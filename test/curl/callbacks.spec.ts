@@ -4,8 +4,17 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  */
+import { AsyncLocalStorage } from 'async_hooks'
+
 import { createServer } from '../helper/server'
-import { Curl, CurlCode, CurlEasyError, CurlPreReqFunc } from '../../lib'
+import {
+  Curl,
+  CurlCode,
+  CurlEasyError,
+  CurlPreReqFunc,
+  ProgressCounter,
+  TransferPhase,
+} from '../../lib'
 import {
   describe,
   beforeAll,
@@ -117,6 +126,96 @@ describe('Callbacks', () => {
       })
     })
 
+    it('should be throttled natively when setProgressThrottle is used', async () => {
+      const performCountingCalls = async () => {
+        const calls: number[] = []
+
+        curl.setProgressCallback((_dltotal, dlnow) => {
+          calls.push(dlnow)
+          return 0
+        })
+
+        await new Promise<void>((resolve, reject) => {
+          curl.on('end', () => resolve())
+          curl.on('error', reject)
+          curl.perform()
+        })
+
+        curl.removeAllListeners()
+        return calls
+      }
+
+      curl.setOpt('URL', `${serverInstance.url}/delayed`)
+      curl.setOpt('NOPROGRESS', false)
+
+      const unthrottledCalls = await performCountingCalls()
+
+      curl.close()
+      curl = new Curl()
+      withCommonTestOptions(curl)
+      curl.setOpt('URL', `${serverInstance.url}/delayed`)
+      curl.setOpt('NOPROGRESS', false)
+      curl.setProgressThrottle({ interval: 60 * 1000 })
+
+      const throttledCalls = await performCountingCalls()
+
+      // the size is not known, so only the first tick reaches the callback
+      expect(throttledCalls).toEqual([0])
+      expect(unthrottledCalls.length).toBeGreaterThan(throttledCalls.length)
+    })
+
+    it.each([
+      ['Float64Array', (buffer: SharedArrayBuffer) => new Float64Array(buffer)],
+      [
+        'BigInt64Array',
+        (buffer: SharedArrayBuffer) => new BigInt64Array(buffer),
+      ],
+    ] as const)(
+      'should publish the progress to a %s',
+      async (_name, createArray) => {
+        const counters = createArray(
+          new SharedArrayBuffer(ProgressCounter.Count * 8),
+        )
+        const phases = new Set<number>()
+
+        curl.setOpt('URL', `${serverInstance.url}/delayed`)
+        curl.setProgressCounters(counters)
+        curl.setOpt('WRITEFUNCTION', (data, size, nmemb) => {
+          phases.add(Number(counters[ProgressCounter.Phase]))
+          return size * nmemb
+        })
+
+        await new Promise<void>((resolve, reject) => {
+          curl.on('end', () => resolve())
+          curl.on('error', reject)
+          curl.perform()
+        })
+
+        const bodyLength = curl.getInfo('SIZE_DOWNLOAD_T')
+
+        expect(Number(counters[ProgressCounter.DownloadNow])).toBe(bodyLength)
+        expect(Number(counters[ProgressCounter.UploadNow])).toBe(0)
+        expect(
+          Number(counters[ProgressCounter.DownloadSpeed]),
+        ).toBeGreaterThan(0)
+        expect(Number(counters[ProgressCounter.Phase])).toBe(
+          TransferPhase.Done,
+        )
+        expect(phases).toContain(TransferPhase.Receiving)
+      },
+    )
+
+    it('should reject invalid throttle options', () => {
+      expect(() => curl.setProgressThrottle({ interval: -1 })).toThrow(
+        RangeError,
+      )
+      expect(() =>
+        // @ts-expect-error testing invalid value
+        curl.setProgressThrottle({ bytes: '10' }),
+      ).toThrow(TypeError)
+      expect(curl.setProgressThrottle(null)).toBe(curl)
+    })
+
     it('should not accept undefined return', async () => {
       curl.setOpt('URL', `${serverInstance.url}/delayed`)
       curl.setOpt('NOPROGRESS', false)
@@ -449,4 +548,29 @@ describe('Callbacks', () => {
       })
     },
   )
+
+  describe('async context', () => {
+    it('should call every callback of a transfer in the context it was started', async () => {
+      const storage = new AsyncLocalStorage<string>()
+      const stores = new Set<string | undefined>()
+
+      curl.setOpt('URL', `${serverInstance.url}/delayed`)
+      curl.setOpt('NOPROGRESS', false)
+      curl.setProgressCallback(() => {
+        stores.add(storage.getStore())
+        return 0
+      })
+      curl.on('header', () => stores.add(storage.getStore()))
+      curl.on('data', () => stores.add(storage.getStore()))
+
+      await new Promise<void>((resolve, reject) => {
+        curl.on('end', () => resolve())
+        curl.on('error', reject)
+
+        storage.run('transfer', () => curl.perform())
+      })
+
+      expect([...stores]).toEqual(['transfer'])
+    })
+  })
 }, 5000)
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, beforeAll, afterAll, it, expect } from 'vitest'
+
+import { createServer } from '../helper/server'
+import { Curl, CurlCode, Easy, Multi } from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+// the response takes way longer than the tests, unless the transfer is cancelled
+const slowResponseDelay = 5000
+
+let serverInstance: ReturnType<typeof createServer>
+
+const createHandle = () => {
+  const handle = new Easy()
+  withCommonTestOptions(handle)
+  handle.setOpt('URL', serverInstance.path('/slow'))
+  return handle
+}
+
+describe('cancel', () => {
+  beforeAll(async () => {
+    serverInstance = createServer()
+    serverInstance.app.get('/slow', (req, res) => {
+      res.writeHead(200, { 'content-type': 'text/plain' })
+      res.write('first chunk')
+
+      const timeout = setTimeout(() => res.end('last chunk'), slowResponseDelay)
+      req.on('close', () => clearTimeout(timeout))
+    })
+    await serverInstance.listen()
+  })
+
+  afterAll(async () => {
+    await serverInstance.close()
+    serverInstance.app._router.stack.pop()
+  })
+
+  it('should reject the transfer with the reason as the cause', async () => {
+    const multi = new Multi()
+    const handle = createHandle()
+    const reason = new Error('cancelled by the test')
+
+    handle.setOpt('WRITEFUNCTION', (_data, size, nmemb) => {
+      setTimeout(() => handle.cancel(reason), 10)
+      return size * nmemb
+    })
+
+    try {
+      const startedAt = Date.now()
+      const error = await multi.perform(handle).catch((e) => e)
+
+      expect(error.code).toBe(CurlCode.CURLE_ABORTED_BY_CALLBACK)
+      expect(error.cause).toBe(reason)
+      expect(Date.now() - startedAt).toBeLessThan(slowResponseDelay)
+      expect(handle.isInsideMultiHandle).toBe(false)
+    } finally {
+      handle.close()
+      multi.close()
+    }
+  })
+
+  it('should abort the transfer when cancelled inside a callback', async () => {
+    const multi = new Multi()
+    const handle = createHandle()
+
+    handle.setOpt('HEADERFUNCTION', (_data, size, nmemb) => {
+      handle.cancel()
+      return size * nmemb
+    })
+
+    try {
+      const error = await multi.perform(handle).catch((e) => e)
+
+      expect(error.code).toBe(CurlCode.CURLE_ABORTED_BY_CALLBACK)
+
+      // the removal is deferred until libcurl returns
+      await new Promise((resolve) => setTimeout(resolve, 50))
+      expect(handle.isInsideMultiHandle).toBe(false)
+
+      // the cancellation does not leak into the next transfer
+      handle.setOpt('URL', serverInstance.path('/slow-missing'))
+      handle.setOpt('HEADERFUNCTION', null)
+      await multi.perform(handle)
+      expect(handle.getInfo('RESPONSE_CODE').data).toBe(404)
+      await new Promise(setImmediate)
+      multi.removeHandle(handle)
+    } finally {
+      handle.close()
+      multi.close()
+    }
+  })
+
+  it('should cancel a request when its abort signal is aborted', async () => {
+    const curl = new Curl()
+    const controller = new AbortController()
+    const reason = new Error('aborted by the test')
+
+    withCommonTestOptions(curl)
+    curl.setOpt('URL', serverInstance.path('/slow'))
+    curl.setAbortSignal(controller.signal)
+
+    const error = await new Promise<Error & { code: CurlCode }>(
+      (resolve, reject) => {
+        curl.on('end', () => reject(new Error('Request was not cancelled')))
+        curl.on('error', (error) => resolve(error))
+        curl.on('header', () => controller.abort(reason))
+        curl.perform()
+      },
+    )
+
+    curl.close()
+
+    expect(error.code).toBe(CurlCode.CURLE_ABORTED_BY_CALLBACK)
+    expect(error.cause).toBe(reason)
+  })
+
+  it('should fail right away if the abort signal was already aborted', async () => {
+    const multi = new Multi()
+    const handle = createHandle()
+
+    handle.setAbortSignal(AbortSignal.abort())
+
+    try {
+      const error = await multi.perform(handle).catch((e) => e)
+
+      expect(error.code).toBe(CurlCode.CURLE_ABORTED_BY_CALLBACK)
+      expect(error.cause).toBeInstanceOf(Error)
+      expect(error.cause.name).toBe('AbortError')
+    } finally {
+      handle.close()
+      multi.close()
+    }
+  })
+})
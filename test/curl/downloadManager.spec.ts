@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, beforeAll, afterAll, afterEach, it, expect } from 'vitest'
+
+import path from 'path'
+import fs from 'fs'
+import crypto from 'crypto'
+
+import { createServer } from '../helper/server'
+import { DownloadCheckpoint, DownloadManager } from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+const fileSize = 2 * 1024 * 1024 + 5
+const sourceFile = path.resolve(__dirname, 'download-source.test')
+const destinationFile = path.resolve(__dirname, 'download-destination.test')
+const checkpointFile = `${destinationFile}.checkpoint.json`
+
+let serverInstance: ReturnType<typeof createServer>
+let fileContents: Buffer
+const requests: { range: string; ifRange: string }[] = []
+
+const createManager = () =>
+  new DownloadManager({
+    connections: 2,
+    minSegmentSize: 1024 * 1024,
+    setupHandle: (handle) => withCommonTestOptions(handle),
+  })
+
+describe('DownloadManager', () => {
+  beforeAll(async () => {
+    fileContents = crypto.randomBytes(fileSize)
+    fs.writeFileSync(sourceFile, fileContents)
+
+    serverInstance = createServer()
+    serverInstance.app.get('/file', (req, res) => {
+      requests.push({
+        range: req.headers.range || '',
+        ifRange: (req.headers['if-range'] as string) || '',
+      })
+      res.sendFile(sourceFile)
+    })
+    await serverInstance.listen()
+  })
+
+  afterAll(async () => {
+    await serverInstance.close()
+    serverInstance.app._router.stack.pop()
+
+    fs.unlinkSync(sourceFile)
+  })
+
+  afterEach(() => {
+    requests.length = 0
+
+    for (const file of [destinationFile, checkpointFile]) {
+      if (fs.existsSync(file)) fs.unlinkSync(file)
+    }
+  })
+
+  // simulates a previous run that stopped in the middle of each segment
+  const createInterruptedDownload = async (etag: string | null) => {
+    const manager = createManager()
+    const url = serverInstance.path('/file')
+
+    try {
+      const result = await manager.download(url, destinationFile)
+      expect(fs.existsSync(checkpointFile)).toBe(false)
+
+      const segments = result.segments.map((segment) => ({
+        ...segment,
+        bytesWritten: Math.floor((segment.end - segment.start + 1) / 3),
+      }))
+
+      // whatever was not written yet is zeroed
+      const partial = Buffer.alloc(fileSize)
+      for (const segment of segments) {
+        fileContents.copy(
+          partial,
+          segment.start,
+          segment.start,
+          segment.start + segment.bytesWritten,
+        )
+      }
+      fs.writeFileSync(destinationFile, partial)
+
+      const checkpoint: DownloadCheckpoint = {
+        version: 1,
+        requestedUrl: url,
+        url: result.url,
+        size: result.size,
+        acceptsRanges: true,
+        etag,
+        lastModified: etag ? null : result.lastModified,
+        segments,
+      }
+      fs.writeFileSync(checkpointFile, JSON.stringify(checkpoint))
+
+      requests.length = 0
+
+      return { url, segments, validator: etag || result.lastModified }
+    } finally {
+      manager.close()
+    }
+  }
+
+  it('should resume a download from its checkpoint', async () => {
+    const { url, segments, validator } = await createInterruptedDownload(null)
+    const manager = createManager()
+
+    try {
+      await manager.download(url, destinationFile)
+    } finally {
+      manager.close()
+    }
+
+    expect(fs.readFileSync(destinationFile).equals(fileContents)).toBe(true)
+    expect(fs.existsSync(checkpointFile)).toBe(false)
+
+    // only the missing bytes were requested
+    expect(requests).toHaveLength(segments.length)
+    expect(requests).toEqual(
+      expect.arrayContaining(
+        segments.map((segment) => ({
+          range: `bytes=${segment.start + segment.bytesWritten}-${segment.end}`,
+          ifRange: validator,
+        })),
+      ),
+    )
+  })
+
+  it('should download again if the file changed since the checkpoint', async () => {
+    const { url } = await createInterruptedDownload('"not-the-same-file"')
+    const manager = createManager()
+
+    try {
+      await manager.download(url, destinationFile)
+    } finally {
+      manager.close()
+    }
+
+    expect(fs.readFileSync(destinationFile).equals(fileContents)).toBe(true)
+    expect(fs.existsSync(checkpointFile)).toBe(false)
+    expect(requests.map((r) => r.range)).toContain('bytes=0-0')
+  })
+})
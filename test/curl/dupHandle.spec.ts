@@ -6,7 +6,7 @@
  */
 /**
  * yay this has code from the httppost and postfields test cases.
- * This was done because the duplicated handle shares the ToFree instances of the original handle,
+ * This was done because the duplicated handle shares the arena of the original handle,
  *  so we need to test their behavior when a handle is duplicated.
  * We can test that easily by testing HTTPPOST and POSTFIELDS.
  */
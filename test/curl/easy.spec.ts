@@ -4,11 +4,26 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  */
+import { spawnSync } from 'child_process'
+import path from 'path'
+
 import { describe, beforeEach, afterEach, it, expect, inject } from 'vitest'
 
-import { Curl, CurlCode, Easy, CurlHttpVersion } from '../../lib'
+import {
+  Curl,
+  CurlCode,
+  Easy,
+  CurlHttpVersion,
+  CurlInfoDebug,
+  ReadBufferMode,
+} from '../../lib'
 import { withCommonTestOptions } from '../helper/commonOptions'
 
+const bindingPath = path.resolve(
+  __dirname,
+  '../../lib/binding/node_libcurl.node',
+)
+
 let curl: Easy
 
 describe('easy', () => {
@@ -29,6 +44,25 @@ describe('easy', () => {
     expect(retCode).toBe(CurlCode.CURLE_OK)
   })
 
+  it('should throw when the handle is closed', () => {
+    const handle = new Easy()
+    handle.close()
+
+    expect(() => handle.setZeroCopy(true)).toThrow('Curl handle is closed')
+    expect(() => handle.setReadBufferMode(ReadBufferMode.Pooled)).toThrow(
+      'Curl handle is closed',
+    )
+    expect(() => handle.setDownloadFile(1)).toThrow('Curl handle is closed')
+    expect(() => handle.setProgressThrottle({ interval: 100 })).toThrow(
+      'Curl handle is closed',
+    )
+    expect(() => handle.setProgressCounters(new Float64Array(8))).toThrow(
+      'Curl handle is closed',
+    )
+    expect(() => handle.setDebugLog({})).toThrow('Curl handle is closed')
+    expect(() => handle.drainDebugLog()).toThrow('Curl handle is closed')
+  })
+
   describe('callbacks', () => {
     it('WRITEFUNCTION - should rethrow error', () => {
       const msg = `Error thrown on callback: ${Date.now()}`
@@ -144,4 +178,94 @@ describe('easy', () => {
       },
     )
   })
+
+  describe('debug log', () => {
+    it('should record the headers of the request and response', () => {
+      curl.setDebugLog({})
+      expect(curl.perform()).toBe(CurlCode.CURLE_OK)
+
+      const { entries, dropped } = curl.drainDebugLog()
+      const types = new Set(entries.map(({ type }) => type))
+
+      expect(dropped).toBe(0)
+      expect(types.has(CurlInfoDebug.HeaderOut)).toBe(true)
+      expect(types.has(CurlInfoDebug.HeaderIn)).toBe(true)
+      expect(types.has(CurlInfoDebug.DataIn)).toBe(false)
+
+      const requestLine = entries.find(
+        ({ type }) => type === CurlInfoDebug.HeaderOut,
+      )
+      expect(requestLine?.data.toString()).toMatch(/^GET \/ HTTP/)
+      expect(requestLine?.handleId).toBe(curl.id)
+
+      for (let i = 1; i < entries.length; i++) {
+        expect(entries[i].timestamp >= entries[i - 1].timestamp).toBe(true)
+      }
+
+      expect(curl.drainDebugLog().entries).toEqual([])
+    })
+
+    it('should truncate entries and overwrite the oldest ones', () => {
+      curl.setDebugLog({
+        capacity: 2,
+        maxDataSize: 4,
+        types: [CurlInfoDebug.HeaderIn],
+      })
+      curl.perform()
+
+      const { entries, dropped } = curl.drainDebugLog()
+
+      expect(entries).toHaveLength(2)
+      expect(dropped).toBeGreaterThan(0)
+
+      for (const entry of entries) {
+        expect(entry.type).toBe(CurlInfoDebug.HeaderIn)
+        expect(entry.data.length).toBeLessThanOrEqual(4)
+        expect(entry.size).toBeGreaterThanOrEqual(entry.data.length)
+      }
+
+      // the last header line is the empty one ending them
+      expect(entries[1].data.toString()).toBe('\r\n')
+    })
+
+    it('should throw when draining without a debug log', () => {
+      expect(() => curl.drainDebugLog()).toThrow(/setDebugLog/)
+
+      curl.setDebugLog({})
+      curl.setDebugLog(null)
+      expect(() => curl.drainDebugLog()).toThrow(/setDebugLog/)
+    })
+
+    it('should not leave VERBOSE enabled once removed', () => {
+      // libcurl prints the verbose output to the stderr of the process itself
+      const { status, stderr } = spawnSync(
+        process.execPath,
+        [
+          '-e',
+          `
+          const { Easy } = require(${JSON.stringify(bindingPath)})
+          const handle = new Easy()
+          handle.setOpt('URL', ${JSON.stringify(inject('httpServerUrl'))})
+          handle.setOpt('WRITEFUNCTION', (data, size, nmemb) => size * nmemb)
+          handle.setDebugLog({})
+          handle.perform()
+          handle.setDebugLog(null)
+          handle.perform()
+          handle.close()
+          `,
+        ],
+        { stdio: 'pipe' },
+      )
+
+      expect(status).toBe(0)
+      expect(stderr.toString()).toBe('')
+    })
+
+    it('should throw on invalid options', () => {
+      expect(() => curl.setDebugLog({ capacity: 0 })).toThrow(RangeError)
+      expect(() =>
+        curl.setDebugLog({ types: [99 as CurlInfoDebug] }),
+      ).toThrow(TypeError)
+    })
+  })
 })
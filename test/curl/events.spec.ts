@@ -15,7 +15,7 @@ import {
 } from 'vitest'
 
 import { createServer } from '../helper/server'
-import { Curl, CurlCode } from '../../lib'
+import { Curl, CurlCode, Multi } from '../../lib'
 import { withCommonTestOptions } from '../helper/commonOptions'
 
 let curl: Curl
@@ -176,4 +176,22 @@ describe('Events', () => {
     expect(error.error).toBeInstanceOf(Error)
     expect(error.errorCode).toBe(CurlCode.CURLE_WRITE_ERROR)
   })
+
+  it('should not emit events after being closed while the request is running', async () => {
+    const multi = new Multi()
+    curl.setMulti(multi)
+
+    try {
+      curl.perform()
+      curl.close()
+
+      // the pending request is settled by the removal, which must not emit anything
+      await new Promise((resolve) => setTimeout(resolve, 50))
+      clearTimeout(timeout)
+
+      expect(multi.getCount()).toBe(0)
+    } finally {
+      multi.close()
+    }
+  })
 })
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, beforeAll, afterAll, it, expect } from 'vitest'
+
+import { createServer } from '../helper/server'
+import { Curl, HeaderList } from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+let serverInstance: ReturnType<typeof createServer>
+
+const requestHeaders = (
+  headers: ConstructorParameters<typeof HeaderList>[0] | HeaderList | any[],
+) =>
+  new Promise<Record<string, string>>((resolve, reject) => {
+    const curl = new Curl()
+    withCommonTestOptions(curl)
+    curl.setOpt('URL', serverInstance.url)
+    curl.setOpt('HTTPHEADER', headers as HeaderList)
+
+    curl.on('end', (_status, data) => {
+      curl.close()
+      resolve(JSON.parse(data as string))
+    })
+
+    curl.on('error', (error) => {
+      curl.close()
+      reject(error)
+    })
+
+    curl.perform()
+  })
+
+describe('HeaderList', () => {
+  beforeAll(async () => {
+    serverInstance = createServer()
+    serverInstance.app.get('/', (req, res) => {
+      res.json(req.headers)
+    })
+    await serverInstance.listen()
+  })
+
+  afterAll(async () => {
+    await serverInstance.close()
+    serverInstance.app._router.stack.pop()
+  })
+
+  it('should expose its items', () => {
+    const list = new HeaderList(['X-Test-A: a', 'X-Test-B: b'])
+
+    expect(list.length).toBe(2)
+    expect(list.toArray()).toEqual(['X-Test-A: a', 'X-Test-B: b'])
+  })
+
+  it('should throw when given anything other than an array of strings', () => {
+    // @ts-expect-error - testing invalid values
+    expect(() => new HeaderList('X-Test: a')).toThrow(TypeError)
+    // @ts-expect-error - testing invalid values
+    expect(() => new HeaderList(['X-Test: a', 1])).toThrow(
+      'HeaderList items must be strings.',
+    )
+  })
+
+  it('should be shareable between multiple handles', async () => {
+    const list = new HeaderList(['X-Test-A: a', 'X-Test-B: b'])
+
+    const results = await Promise.all([
+      requestHeaders(list),
+      requestHeaders(list),
+      requestHeaders(list),
+    ])
+
+    for (const headers of results) {
+      expect(headers['x-test-a']).toBe('a')
+      expect(headers['x-test-b']).toBe('b')
+    }
+  })
+
+  it('should send the items given before the list in the same array', async () => {
+    const list = new HeaderList(['X-Test-A: a'])
+
+    const [first, second] = await Promise.all([
+      requestHeaders(['X-Request: 1', list]),
+      requestHeaders(['X-Request: 2', list]),
+    ])
+
+    expect(first['x-test-a']).toBe('a')
+    expect(first['x-request']).toBe('1')
+    expect(second['x-test-a']).toBe('a')
+    expect(second['x-request']).toBe('2')
+
+    // the shared list must not have been modified by the handles
+    expect(list.toArray()).toEqual(['X-Test-A: a'])
+  })
+
+  it('should only be allowed as the last item of an array', () => {
+    const curl = new Curl()
+    const list = new HeaderList(['X-Test-A: a'])
+
+    expect(() =>
+      curl.setOpt('HTTPHEADER', [list, 'X-Request: 1'] as any),
+    ).toThrow('A HeaderList can only be used as the last item of the Array.')
+
+    curl.close()
+  })
+})
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { execFileSync } from 'child_process'
+import path from 'path'
+
+import { describe, it, expect } from 'vitest'
+
+import { Curl } from '../../lib'
+
+const bindingPath = path.resolve(
+  __dirname,
+  '../../lib/binding/node_libcurl.node',
+)
+
+// the mode is decided when libcurl is initialized, so it needs a new process
+const runWithTracking = (
+  script: string,
+  env: Record<string, string> = { NODE_LIBCURL_TRACK_MEMORY: '1' },
+) => {
+  const requireBinding = `const binding = require(${JSON.stringify(bindingPath)})`
+  const output = execFileSync(
+    process.execPath,
+    ['-e', `${requireBinding}\n${script}`],
+    { env: { ...process.env, ...env }, stdio: 'pipe' },
+  )
+
+  return JSON.parse(output.toString())
+}
+
+describe('memory usage', () => {
+  it('should not track anything by default', () => {
+    expect(Curl.getMemoryUsage()).toEqual({
+      tracked: false,
+      allocator: expect.any(String),
+      total: 0,
+      reported: expect.any(Number),
+      categories: { handles: 0, options: 0, transfers: 0, other: 0 },
+    })
+  })
+
+  it('should count the memory allocated by libcurl when enabled', () => {
+    const result = runWithTracking(`
+      const { Curl, Easy } = binding
+      const handles = Array.from({ length: 100 }, () => new Easy())
+      handles.forEach((handle) =>
+        handle.setOpt(Curl.option.USERAGENT, 'x'.repeat(1024)),
+      )
+
+      const whileOpen = Curl.getMemoryUsage()
+      handles.forEach((handle) => handle.close())
+      const afterClose = Curl.getMemoryUsage()
+
+      console.log(JSON.stringify({ whileOpen, afterClose }))
+    `)
+
+    const { whileOpen, afterClose } = result
+
+    expect(whileOpen.tracked).toBe(true)
+    expect(whileOpen.categories.handles).toBeGreaterThan(0)
+    // each handle has its own copy of the user agent
+    expect(whileOpen.categories.options).toBeGreaterThanOrEqual(100 * 1024)
+    expect(whileOpen.total).toBe(
+      whileOpen.categories.handles +
+        whileOpen.categories.options +
+        whileOpen.categories.transfers +
+        whileOpen.categories.other,
+    )
+    // small changes are not reported right away
+    expect(Math.abs(whileOpen.reported - whileOpen.total)).toBeLessThan(
+      64 * 1024,
+    )
+
+    expect(afterClose.categories.options).toBe(0)
+    expect(afterClose.total).toBeLessThan(whileOpen.total)
+  })
+
+  it('should use the allocator selected at runtime', () => {
+    const script = `console.log(JSON.stringify(binding.Curl.getMemoryUsage()))`
+
+    expect(
+      runWithTracking(script, { NODE_LIBCURL_ALLOCATOR: 'system' }),
+    ).toMatchObject({ tracked: false, allocator: 'system' })
+
+    expect(() =>
+      runWithTracking(script, { NODE_LIBCURL_ALLOCATOR: 'not-an-allocator' }),
+    ).toThrow(/NODE_LIBCURL_ALLOCATOR must be/)
+  })
+})
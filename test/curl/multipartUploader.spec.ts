@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, beforeAll, afterAll, afterEach, it, expect } from 'vitest'
+
+import path from 'path'
+import fs from 'fs'
+import crypto from 'crypto'
+
+import { createServer } from '../helper/server'
+import {
+  MultipartUploader,
+  MultipartUploadError,
+  MultipartUploaderOptions,
+} from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+const partSize = 1024 * 1024
+const fileSize = 2 * partSize + 123
+const sourceFile = path.resolve(__dirname, 'multipart-source.test')
+
+let serverInstance: ReturnType<typeof createServer>
+let fileContents: Buffer
+const receivedParts = new Map<number, Buffer>()
+// status codes to answer the next requests of each part with
+const failures = new Map<number, number[]>()
+
+const md5 = (data: Buffer) =>
+  `"${crypto.createHash('md5').update(data).digest('hex')}"`
+
+const createUploader = (options: Partial<MultipartUploaderOptions> = {}) =>
+  new MultipartUploader({
+    partSize,
+    concurrency: 2,
+    retryDelay: 10,
+    setupPartHandle: (handle, part) => {
+      withCommonTestOptions(handle)
+      handle.setOpt(
+        'URL',
+        serverInstance.path(`/upload?partNumber=${part.partNumber}`),
+      )
+    },
+    ...options,
+  })
+
+describe('MultipartUploader', () => {
+  beforeAll(async () => {
+    fileContents = crypto.randomBytes(fileSize)
+    fs.writeFileSync(sourceFile, fileContents)
+
+    serverInstance = createServer()
+    serverInstance.app.put('/upload', (req, res) => {
+      const partNumber = Number(req.query.partNumber)
+      const chunks: Buffer[] = []
+
+      req.on('data', (chunk: Buffer) => chunks.push(chunk))
+      req.on('end', () => {
+        const status = failures.get(partNumber)?.shift()
+        if (status) {
+          res.status(status).end()
+          return
+        }
+
+        const body = Buffer.concat(chunks)
+        receivedParts.set(partNumber, body)
+        res.set('ETag', md5(body)).status(200).end()
+      })
+    })
+    await serverInstance.listen()
+  })
+
+  afterAll(async () => {
+    await serverInstance.close()
+    serverInstance.app._router.stack.pop()
+
+    fs.unlinkSync(sourceFile)
+  })
+
+  afterEach(() => {
+    receivedParts.clear()
+    failures.clear()
+  })
+
+  it('should upload all parts and return their etags in order', async () => {
+    const uploader = createUploader()
+
+    try {
+      const parts = await uploader.upload(sourceFile)
+
+      expect(parts.map(({ partNumber }) => partNumber)).toEqual([1, 2, 3])
+
+      for (const part of parts) {
+        const expected = fileContents.subarray(
+          part.offset,
+          part.offset + part.length,
+        )
+        expect(receivedParts.get(part.partNumber)?.equals(expected)).toBe(true)
+        expect(part.etag).toBe(md5(expected))
+      }
+
+      const uploaded = parts.map(
+        ({ partNumber }) => receivedParts.get(partNumber) as Buffer,
+      )
+      expect(Buffer.concat(uploaded)).toEqual(fileContents)
+    } finally {
+      uploader.close()
+    }
+  })
+
+  it('should retry parts failing with a retryable status code', async () => {
+    failures.set(2, [503, 429])
+    const uploader = createUploader()
+
+    try {
+      const parts = await uploader.upload(sourceFile)
+
+      expect(parts.map(({ attempts }) => attempts)).toEqual([1, 3, 1])
+      expect(receivedParts.get(2)).toEqual(
+        fileContents.subarray(partSize, 2 * partSize),
+      )
+    } finally {
+      uploader.close()
+    }
+  })
+
+  it('should fail without retrying on other status codes', async () => {
+    failures.set(3, [403])
+    const uploader = createUploader()
+
+    try {
+      const error = await uploader.upload(sourceFile).catch((e) => e)
+
+      expect(error).toBeInstanceOf(MultipartUploadError)
+      expect(error.statusCode).toBe(403)
+      expect(error.part.partNumber).toBe(3)
+      expect(error.part.attempts).toBe(1)
+    } finally {
+      uploader.close()
+    }
+  })
+
+  it('should give up after maxRetries', async () => {
+    failures.set(1, [500, 500, 500])
+    const uploader = createUploader({ maxRetries: 1 })
+
+    try {
+      const error = await uploader.upload(sourceFile).catch((e) => e)
+
+      expect(error).toBeInstanceOf(MultipartUploadError)
+      expect(error.statusCode).toBe(500)
+      expect(error.part.attempts).toBe(2)
+    } finally {
+      uploader.close()
+    }
+  })
+
+  it('should split files in parts', () => {
+    expect(MultipartUploader.splitParts(10, 4)).toEqual([
+      { partNumber: 1, offset: 0, length: 4, etag: null, attempts: 0 },
+      { partNumber: 2, offset: 4, length: 4, etag: null, attempts: 0 },
+      { partNumber: 3, offset: 8, length: 2, etag: null, attempts: 0 },
+    ])
+    expect(MultipartUploader.splitParts(0, 4)).toEqual([
+      { partNumber: 1, offset: 0, length: 0, etag: null, attempts: 0 },
+    ])
+  })
+})
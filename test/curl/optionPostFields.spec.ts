@@ -44,6 +44,9 @@ describe('Option POSTFIELDS', () => {
     serverInstance.app.post('/', (req, res) => {
       res.send(JSON.stringify(req.body))
     })
+    serverInstance.app.post('/raw', (req, res) => {
+      res.send((req.body as Buffer).toString('hex'))
+    })
     await serverInstance.listen()
   })
 
@@ -80,4 +83,69 @@ describe('Option POSTFIELDS', () => {
       }
     }
   })
+
+  it('should post the correct data after the handle is reset', async () => {
+    // the handle memory is recycled on reset, make sure nothing from the
+    // previous options leaks into the next request
+    curl.setOpt('POSTFIELDS', 'a'.repeat(64 * 1024))
+    curl.setOpt('HTTPHEADER', ['X-First-Request: true'])
+    curl.reset()
+
+    withCommonTestOptions(curl)
+    curl.setOpt('URL', serverInstance.url)
+    curl.setOpt('HTTPHEADER', ['X-Second-Request: true'])
+    curl.setOpt('POSTFIELDS', querystring.stringify(postData))
+
+    const result = await new Promise<string>((resolve, reject) => {
+      curl.on('end', (status, data) => {
+        if (status !== 200) {
+          reject(new Error(`Invalid status code: ${status}`))
+          return
+        }
+
+        resolve(data as string)
+      })
+
+      curl.on('error', reject)
+
+      curl.perform()
+    })
+
+    expect(JSON.parse(result)).toEqual(postData)
+  })
+
+  describe.each([
+    ['copied', false],
+    ['zero copy', true],
+  ])('with binary data (%s)', (_, isZeroCopy) => {
+    it('should post the contents of the buffer', async () => {
+      // null bytes included, so this fails if the data is handled as a C string
+      const data = Buffer.from([0x00, 0x01, 0x02, 0xff, 0x00, 0x7f, 0x80])
+      // a view in the middle of a larger ArrayBuffer
+      const view = new Uint8Array(16)
+      view.set(data, 4)
+
+      curl.setOpt('URL', `${serverInstance.url}/raw`)
+      curl.setOpt('HTTPHEADER', ['Content-Type: application/node-libcurl.raw'])
+      if (isZeroCopy) curl.handle.setZeroCopy(true)
+      curl.setOpt('POSTFIELDS', view.subarray(4, 4 + data.length))
+
+      const result = await new Promise<string>((resolve, reject) => {
+        curl.on('end', (status, body) => {
+          if (status !== 200) {
+            reject(new Error(`Invalid status code: ${status}`))
+            return
+          }
+
+          resolve(body as string)
+        })
+
+        curl.on('error', reject)
+
+        curl.perform()
+      })
+
+      expect(result).toBe(data.toString('hex'))
+    })
+  })
 })
@@ -21,7 +21,7 @@ import crypto from 'crypto'
 import express from 'express'
 
 import { createServer, ServerInstance } from '../helper/server'
-import { Curl } from '../../lib'
+import { Curl, ReadBufferMode } from '../../lib'
 
 import http from 'http'
 import { withCommonTestOptions } from '../helper/commonOptions'
@@ -112,6 +112,11 @@ describe('Put Upload', () => {
       })
     })
 
+    // libcurl has to rewind the upload to send it again to the new location
+    serverInstance.app.put('/redirect/:filename', (req, res) => {
+      res.redirect(307, `/upload/${req.params['filename']}`)
+    })
+
     serverInstance.app.use(
       (
         error: any,
@@ -135,6 +140,7 @@ describe('Put Upload', () => {
 
     serverInstance.app._router.stack.pop()
     serverInstance.app._router.stack.pop()
+    serverInstance.app._router.stack.pop()
   })
 
   it('should upload data correctly using put', async () => {
@@ -163,6 +169,73 @@ describe('Put Upload', () => {
     expect(result.body).toBe(fileHash)
   })
 
+  it('should upload a file bigger than the read-ahead blocks using put', async () => {
+    // the file is read in blocks of 128KiB, make sure they are stitched together correctly
+    fs.writeFileSync(fileName, crypto.randomBytes(1024 * 1024 + 123))
+    const bigFileHash = await new Promise<string>((resolve, reject) => {
+      hashOfFile(fileName, (error, hash) =>
+        error ? reject(error) : resolve(hash),
+      )
+    })
+
+    const fd = fs.openSync(fileName, 'r')
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('READDATA', fd)
+
+    const result = await new Promise<{ statusCode: number; body: string }>(
+      (resolve, reject) => {
+        curl.on('end', (statusCode, body) => {
+          fs.closeSync(fd)
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.on('error', (error) => {
+          fs.closeSync(fd)
+          reject(error)
+        })
+
+        curl.perform()
+      },
+    )
+
+    expect(result.statusCode).toBe(200)
+    expect(result.body).toBe(bigFileHash)
+  })
+
+  it('should read READDATA again on the next transfer of the same handle', async () => {
+    const fd = fs.openSync(fileName, 'r')
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('READDATA', fd)
+
+    const performUpload = () =>
+      new Promise<string>((resolve, reject) => {
+        curl.once('end', (_statusCode, body) => {
+          curl.off('error', reject)
+          resolve(body as string)
+        })
+
+        curl.once('error', reject)
+
+        curl.perform()
+      })
+
+    try {
+      expect(await performUpload()).toBe(fileHash)
+
+      // the file grew, the next transfer reads from where the previous one stopped
+      const appended = crypto.randomBytes(fileSize)
+      fs.appendFileSync(fileName, appended)
+
+      expect(await performUpload()).toBe(
+        crypto.createHash('sha1').update(appended).digest('hex'),
+      )
+    } finally {
+      fs.closeSync(fd)
+    }
+  })
+
   it('should upload data correctly using READFUNCTION callback option', async () => {
     const CURL_READFUNC_PAUSE = 0x10000001
     const CURL_READFUNC_ABORT = 0x10000000
@@ -234,6 +307,244 @@ describe('Put Upload', () => {
     expect(result.body).toBe(fileHash)
   })
 
+  it.each([
+    ['Copy', ReadBufferMode.Copy],
+    ['Pooled', ReadBufferMode.Pooled],
+    ['Borrowed', ReadBufferMode.Borrowed],
+  ])(
+    'should upload data correctly using READFUNCTION with ReadBufferMode.%s',
+    async (_, mode) => {
+      const data = fs.readFileSync(fileName)
+      const buffersReceived: Buffer[] = []
+      let offset = 0
+
+      curl.setOpt('UPLOAD', 1)
+      curl.setOpt('INFILESIZE_LARGE', data.length)
+      curl.setOpt('READFUNCTION', (targetBuffer: Buffer) => {
+        buffersReceived.push(targetBuffer)
+
+        const written = data.copy(targetBuffer, 0, offset)
+        offset += written
+        return written
+      })
+      curl.handle.setReadBufferMode(mode)
+
+      const result = await new Promise<{ statusCode: number; body: string }>(
+        (resolve, reject) => {
+          curl.on('end', (statusCode, body) => {
+            resolve({ statusCode, body: body as string })
+          })
+
+          curl.on('error', reject)
+
+          curl.perform()
+        },
+      )
+
+      expect(result.statusCode).toBe(200)
+      expect(result.body).toBe(fileHash)
+
+      if (mode === ReadBufferMode.Borrowed) {
+        // libcurl memory must not be reachable after the callback returns
+        for (const buffer of buffersReceived) {
+          expect(buffer.length).toBe(0)
+        }
+      }
+    },
+  )
+
+  it('should not keep ReadBufferMode.Borrowed after a stream upload', async () => {
+    const performUpload = () =>
+      new Promise<{ statusCode: number; body: string }>((resolve, reject) => {
+        curl.once('end', (statusCode, body) => {
+          curl.off('error', reject)
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.once('error', reject)
+
+        curl.perform()
+      })
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setUploadStream(fs.createReadStream(fileName))
+
+    expect((await performUpload()).body).toBe(fileHash)
+
+    // the callback set by the user afterwards gets Buffers it can keep
+    const data = fs.readFileSync(fileName)
+    const buffersReceived: Buffer[] = []
+    let offset = 0
+
+    curl.setOpt('INFILESIZE_LARGE', data.length)
+    curl.setOpt('READFUNCTION', (targetBuffer: Buffer) => {
+      buffersReceived.push(targetBuffer)
+
+      const written = data.copy(targetBuffer, 0, offset)
+      offset += written
+      return written
+    })
+
+    expect((await performUpload()).body).toBe(fileHash)
+
+    for (const buffer of buffersReceived) {
+      expect(buffer.length).toBeGreaterThan(0)
+    }
+  })
+
+  it('should upload data correctly using a list of buffers', async () => {
+    const data = fs.readFileSync(fileName)
+    const buffers = [
+      data.subarray(0, 1000),
+      Buffer.alloc(0),
+      new Uint8Array(data.buffer, data.byteOffset + 1000, 4000),
+      data.subarray(5000),
+    ]
+
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadBuffers(buffers)
+
+    const result = await new Promise<{ statusCode: number; body: string }>(
+      (resolve, reject) => {
+        curl.on('end', (statusCode, body) => {
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.on('error', reject)
+
+        curl.perform()
+      },
+    )
+
+    expect(result.statusCode).toBe(200)
+    expect(result.body).toBe(fileHash)
+  })
+
+  it('should upload the list of buffers again on the next transfer of the same handle', async () => {
+    const data = fs.readFileSync(fileName)
+
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadBuffers([data.subarray(0, 5000), data.subarray(5000)])
+
+    const performUpload = () =>
+      new Promise<string>((resolve, reject) => {
+        curl.once('end', (_statusCode, body) => {
+          curl.off('error', reject)
+          resolve(body as string)
+        })
+
+        curl.once('error', reject)
+
+        curl.perform()
+      })
+
+    expect(await performUpload()).toBe(fileHash)
+    expect(await performUpload()).toBe(fileHash)
+  })
+
+  it('should rewind the list of buffers when following a redirect', async () => {
+    const data = fs.readFileSync(fileName)
+
+    curl.setOpt('URL', serverInstance.path('/redirect/upload-result.test'))
+    curl.setOpt('FOLLOWLOCATION', true)
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadBuffers([
+      data.subarray(0, 3000),
+      data.subarray(3000, 7000),
+      data.subarray(7000),
+    ])
+
+    const result = await new Promise<{ statusCode: number; body: string }>(
+      (resolve, reject) => {
+        curl.on('end', (statusCode, body) => {
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.on('error', reject)
+
+        curl.perform()
+      },
+    )
+
+    expect(result.statusCode).toBe(200)
+    expect(curl.getInfo('REDIRECT_COUNT')).toBe(1)
+    expect(result.body).toBe(fileHash)
+  })
+
+  it('should upload data correctly using a memory mapped file', async () => {
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadFile(fileName)
+
+    const result = await new Promise<{ statusCode: number; body: string }>(
+      (resolve, reject) => {
+        curl.on('end', (statusCode, body) => {
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.on('error', reject)
+
+        curl.perform()
+      },
+    )
+
+    expect(result.statusCode).toBe(200)
+    expect(result.body).toBe(fileHash)
+  })
+
+  it('should upload the memory mapped file again on the next transfer of the same handle', async () => {
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadFile(fileName)
+
+    const performUpload = () =>
+      new Promise<string>((resolve, reject) => {
+        curl.once('end', (_statusCode, body) => {
+          curl.off('error', reject)
+          resolve(body as string)
+        })
+
+        curl.once('error', reject)
+
+        curl.perform()
+      })
+
+    expect(await performUpload()).toBe(fileHash)
+    expect(await performUpload()).toBe(fileHash)
+  })
+
+  it('should upload only the given range of a memory mapped file', async () => {
+    const rangeHash = crypto
+      .createHash('sha1')
+      .update(fs.readFileSync(fileName).subarray(1234, 1234 + 5000))
+      .digest('hex')
+
+    curl.setOpt('UPLOAD', 1)
+    curl.handle.setUploadFile(fileName, { offset: 1234, length: 5000 })
+
+    const result = await new Promise<{ statusCode: number; body: string }>(
+      (resolve, reject) => {
+        curl.on('end', (statusCode, body) => {
+          resolve({ statusCode, body: body as string })
+        })
+
+        curl.on('error', reject)
+
+        curl.perform()
+      },
+    )
+
+    expect(result.statusCode).toBe(200)
+    expect(result.body).toBe(rangeHash)
+  })
+
+  it('should throw when the file range to be uploaded is invalid', () => {
+    expect(() =>
+      curl.handle.setUploadFile(fileName, { offset: fileSize + 1 }),
+    ).toThrow(/out of the bounds/)
+    expect(() =>
+      curl.handle.setUploadFile(path.resolve(__dirname, 'does-not-exist')),
+    ).toThrow(/Could not map the file/)
+  })
+
   it('should abort upload with invalid fd', async () => {
     curl.setOpt('UPLOAD', 1)
     curl.setOpt('READDATA', -1)
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, beforeAll, afterAll, afterEach, it, expect } from 'vitest'
+
+import path from 'path'
+import fs from 'fs'
+import crypto from 'crypto'
+
+import { createServer } from '../helper/server'
+import { RangeDownloader, RangeDownloadSegment } from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+const fileSize = 3 * 1024 * 1024 + 17
+const sourceFile = path.resolve(__dirname, 'range-source.test')
+const destinationFile = path.resolve(__dirname, 'range-destination.test')
+
+let serverInstance: ReturnType<typeof createServer>
+let fileContents: Buffer
+const rangesRequested: string[] = []
+
+describe('RangeDownloader', () => {
+  beforeAll(async () => {
+    fileContents = crypto.randomBytes(fileSize)
+    fs.writeFileSync(sourceFile, fileContents)
+
+    serverInstance = createServer()
+    serverInstance.app.get('/file', (req, res) => {
+      rangesRequested.push(req.headers.range || '')
+      res.sendFile(sourceFile)
+    })
+    serverInstance.app.get('/no-ranges', (_req, res) => {
+      res.send(fileContents)
+    })
+    // the first segment never ends, and the others fail
+    serverInstance.app.get('/failing-segments', (req, res) => {
+      if (req.headers.range === 'bytes=0-0') {
+        res.sendFile(sourceFile)
+      } else if (!req.headers.range?.startsWith('bytes=0-')) {
+        res.status(500).end()
+      }
+    })
+    await serverInstance.listen()
+  })
+
+  afterAll(async () => {
+    await serverInstance.close()
+    serverInstance.app._router.stack.pop()
+    serverInstance.app._router.stack.pop()
+    serverInstance.app._router.stack.pop()
+
+    fs.unlinkSync(sourceFile)
+  })
+
+  afterEach(() => {
+    rangesRequested.length = 0
+
+    if (fs.existsSync(destinationFile)) {
+      fs.unlinkSync(destinationFile)
+    }
+  })
+
+  it('should download the file in segments', async () => {
+    const segmentsEnded: RangeDownloadSegment[] = []
+    const downloader = new RangeDownloader({
+      connections: 4,
+      minSegmentSize: 512 * 1024,
+      setupHandle: (handle) => withCommonTestOptions(handle),
+      onSegmentEnd: (segment) => segmentsEnded.push({ ...segment }),
+    })
+
+    try {
+      const result = await downloader.download(
+        serverInstance.path('/file'),
+        destinationFile,
+      )
+
+      expect(result.size).toBe(fileSize)
+      expect(result.acceptsRanges).toBe(true)
+      expect(result.segments).toHaveLength(4)
+      expect(segmentsEnded).toHaveLength(4)
+      expect(rangesRequested).toEqual(
+        expect.arrayContaining([
+          'bytes=0-0',
+          ...result.segments.map((s) => `bytes=${s.start}-${s.end}`),
+        ]),
+      )
+      expect(fs.readFileSync(destinationFile).equals(fileContents)).toBe(true)
+    } finally {
+      downloader.close()
+    }
+  })
+
+  it('should download using a single connection if the server does not support ranges', async () => {
+    const downloader = new RangeDownloader({
+      setupHandle: (handle) => withCommonTestOptions(handle),
+    })
+
+    try {
+      const result = await downloader.download(
+        serverInstance.path('/no-ranges'),
+        destinationFile,
+      )
+
+      expect(result.acceptsRanges).toBe(false)
+      expect(result.size).toBe(fileSize)
+      expect(fs.readFileSync(destinationFile).equals(fileContents)).toBe(true)
+    } finally {
+      downloader.close()
+    }
+  })
+
+  it('should stop the other segments when one of them fails', async () => {
+    const downloader = new RangeDownloader({
+      connections: 4,
+      minSegmentSize: 512 * 1024,
+      setupHandle: (handle) => withCommonTestOptions(handle),
+    })
+
+    try {
+      await expect(
+        downloader.download(
+          serverInstance.path('/failing-segments'),
+          destinationFile,
+        ),
+      ).rejects.toThrow()
+    } finally {
+      downloader.close()
+    }
+  })
+
+  it('should split ranges evenly', () => {
+    expect(RangeDownloader.splitRanges(10, 3, 1)).toEqual([
+      { start: 0, end: 2, bytesWritten: 0 },
+      { start: 3, end: 5, bytesWritten: 0 },
+      { start: 6, end: 9, bytesWritten: 0 },
+    ])
+    expect(RangeDownloader.splitRanges(10, 8, 6)).toEqual([
+      { start: 0, end: 9, bytesWritten: 0 },
+    ])
+    expect(RangeDownloader.splitRanges(0, 8, 1)).toEqual([])
+  })
+})
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { describe, afterEach, it, expect, inject } from 'vitest'
+
+import {
+  Curl,
+  CurlCode,
+  Easy,
+  Multi,
+  TraceCallback,
+  TraceEvent,
+  toChromeTrace,
+} from '../../lib'
+import { withCommonTestOptions } from '../helper/commonOptions'
+
+const createHandle = () => {
+  const handle = new Easy()
+  withCommonTestOptions(handle)
+  handle.setOpt('URL', inject('httpServerUrl'))
+  return handle
+}
+
+describe('trace', () => {
+  afterEach(() => {
+    Curl.setTraceEnabled(false)
+    Curl.drainTrace()
+  })
+
+  it('should not record anything while disabled', () => {
+    const handle = createHandle()
+
+    try {
+      expect(Curl.isTraceEnabled()).toBe(false)
+      expect(handle.perform()).toBe(CurlCode.CURLE_OK)
+      expect(Curl.drainTrace()).toEqual({ dropped: 0, records: [] })
+    } finally {
+      handle.close()
+    }
+  })
+
+  it('should record the steps of a transfer inside a multi handle', async () => {
+    const multi = new Multi()
+    const handle = createHandle()
+
+    Curl.setTraceEnabled(true)
+    expect(Curl.isTraceEnabled()).toBe(true)
+
+    try {
+      await multi.perform(handle)
+
+      const { dropped, records } = Curl.drainTrace()
+      const events = records.map((record) => record.event)
+
+      expect(dropped).toBe(0)
+      expect(events).toContain(TraceEvent.MultiAddHandle)
+      expect(events).toContain(TraceEvent.MultiSocketAction)
+      expect(events).toContain(TraceEvent.MultiOnSocket)
+
+      const done = records.find(
+        (record) => record.event === TraceEvent.MultiTransferDone,
+      )
+      expect(done).toMatchObject({
+        handleId: handle.id,
+        value: CurlCode.CURLE_OK,
+      })
+      // 0 is only used for records that are not from a handle
+      expect(done?.multiId).toBeGreaterThan(0)
+      expect(handle.id).toBeGreaterThan(0)
+
+      // timestamps are monotonic, and the buffer was emptied
+      const timestamps = records.map((record) => record.timestamp)
+      const sorted = [...timestamps].sort((a, b) => (a < b ? -1 : 1))
+      expect(timestamps).toEqual(sorted)
+      expect(Curl.drainTrace().records).toHaveLength(0)
+    } finally {
+      // the multi handle does not remove finished handles, and it cannot be done
+      // from inside its callbacks, see https://github.com/JCMais/node-libcurl/issues/439
+      await new Promise((resolve) => setImmediate(resolve))
+      if (handle.isInsideMultiHandle) multi.removeHandle(handle)
+      handle.close()
+      multi.close()
+    }
+  })
+
+  it('should overwrite the oldest records once full', () => {
+    const handle = createHandle()
+
+    try {
+      // besides EasyPerform, each transfer records its start, end and times
+      Curl.setTraceEnabled(true)
+      handle.perform()
+      const recordsPerPerform = Curl.drainTrace().records.length
+      expect(recordsPerPerform).toBeGreaterThan(1)
+
+      Curl.setTraceEnabled(true, 1)
+      handle.perform()
+      handle.perform()
+
+      const { dropped, records } = Curl.drainTrace()
+
+      expect(dropped).toBe(recordsPerPerform * 2 - 1)
+      expect(records).toHaveLength(1)
+      expect(records[0]).toMatchObject({
+        event: TraceEvent.EasyPerform,
+        handleId: handle.id,
+        value: CurlCode.CURLE_OK,
+      })
+      expect(records[0].duration).toBeGreaterThan(0)
+    } finally {
+      Curl.setTraceEnabled(false, 8192)
+      handle.close()
+    }
+  })
+
+  it('should export the transfers and their callbacks as a chrome trace', async () => {
+    const multi = new Multi()
+    const handle = createHandle()
+
+    handle.setOpt('WRITEFUNCTION', (_data, size, nmemb) => size * nmemb)
+
+    Curl.setTraceEnabled(true)
+
+    try {
+      await multi.perform(handle)
+
+      const { records } = Curl.drainTrace()
+      expect(records.map((record) => record.event)).toContain(
+        TraceEvent.EasyCallback,
+      )
+
+      const { traceEvents } = toChromeTrace(records, { pid: 1 })
+      const handleEvents = traceEvents.filter(
+        (event) => event.tid === handle.id,
+      )
+      const names = handleEvents.map((event) => event.name)
+
+      expect(names).toContain('transfer')
+      expect(names).toContain('receive')
+      expect(names).toContain(TraceCallback[TraceCallback.Write])
+      expect(names).toContain('added to multi')
+
+      const transfer = handleEvents.find((event) => event.name === 'transfer')!
+      expect(transfer).toMatchObject({
+        ph: 'X',
+        pid: 1,
+        args: { code: 'CURLE_OK' },
+      })
+
+      // the callbacks happen during the transfer
+      for (const event of handleEvents.filter((e) => e.cat === 'callback')) {
+        expect(event.ts).toBeGreaterThanOrEqual(transfer.ts)
+        expect(event.ts + event.dur!).toBeLessThanOrEqual(
+          transfer.ts + transfer.dur!,
+        )
+      }
+
+      expect(JSON.parse(JSON.stringify(traceEvents))).toEqual(traceEvents)
+    } finally {
+      await new Promise((resolve) => setImmediate(resolve))
+      if (handle.isInsideMultiHandle) multi.removeHandle(handle)
+      handle.close()
+      multi.close()
+    }
+  })
+
+  it('should validate the capacity', () => {
+    expect(() => Curl.setTraceEnabled(true, 0)).toThrow(RangeError)
+    expect(Curl.isTraceEnabled()).toBe(false)
+  })
+})
@@ -0,0 +1,200 @@
+/**
+ * Stress test for creating and terminating worker threads that use the addon.
+ *
+ * Each worker loads the addon, which creates its own instance data, and runs
+ * transfers on its own Multi handle. Half of them are terminated while those
+ * transfers are still running, so the cleanup hooks of the addon have to
+ * close handles that are in use, the other half finish and exit by
+ * themselves. Pools usually run 8 to 32 workers per process, and recycle them,
+ * so this must not crash, leak the memory of each environment, nor affect the
+ * other workers.
+ *
+ * The memory of the environments is only released once the workers exit, so
+ * the growth of the RSS is checked after the churn, against a generous limit.
+ */
+import { describe, it, expect, beforeAll, afterAll } from 'vitest'
+import http from 'http'
+import path from 'path'
+import type { AddressInfo } from 'net'
+import { Worker } from 'worker_threads'
+
+const TARGET_DURATION_MS = Number(process.env.STRESS_DURATION_MS ?? 10_000)
+const WORKERS_PER_WAVE = Number(process.env.STRESS_WORKERS ?? 8)
+const STARTUP_WORKERS = Number(process.env.STRESS_STARTUP_WORKERS ?? 32)
+const MAX_RSS_GROWTH_MB = Number(process.env.STRESS_MAX_RSS_GROWTH_MB ?? 256)
+
+const bindingPath = path.resolve(
+  __dirname,
+  '../../lib/binding/node_libcurl.node',
+)
+
+// CommonJS, evaluated by each worker
+const workerSource = `
+const { parentPort, workerData } = require('worker_threads')
+const { Easy, Multi } = require(workerData.bindingPath)
+
+const multi = new Multi()
+const handles = Array.from({ length: workerData.concurrency }, () => {
+  const easy = new Easy()
+  easy.setOpt('URL', workerData.url)
+  easy.setOpt('WRITEFUNCTION', (data, size, nmemb) => size * nmemb)
+  return easy
+})
+
+const run = async (easy) => {
+  for (let i = 0; i < workerData.requests; i++) {
+    await multi.perform(easy)
+    // finished handles stay inside the multi handle, and they cannot be removed
+    // from inside its callbacks
+    await new Promise((resolve) => setImmediate(resolve))
+    multi.removeHandle(easy)
+    parentPort.postMessage({ type: 'completed' })
+  }
+}
+
+parentPort.postMessage({ type: 'ready' })
+
+Promise.all(handles.map(run)).then(
+  () => {
+    for (const easy of handles) easy.close()
+    multi.close()
+    parentPort.postMessage({ type: 'done' })
+  },
+  (error) => {
+    parentPort.postMessage({ type: 'error', message: String(error?.message ?? error) })
+  },
+)
+`
+
+interface WorkerOutcome {
+  exitCode: number
+  completed: number
+  errors: string[]
+}
+
+describe('stress: worker churn', () => {
+  let server: http.Server
+  let baseUrl: string
+
+  beforeAll(async () => {
+    server = http.createServer((req, res) => {
+      // slow enough for transfers to be running when the worker is terminated
+      const delay = req.url === '/slow' ? 20 : 0
+      setTimeout(() => {
+        res.writeHead(200, { 'Content-Type': 'text/plain' })
+        res.end('ok'.repeat(512))
+      }, delay)
+    })
+    server.keepAliveTimeout = 60_000
+    await new Promise<void>((resolve) =>
+      server.listen(0, '127.0.0.1', resolve),
+    )
+    const addr = server.address() as AddressInfo
+    baseUrl = `http://127.0.0.1:${addr.port}`
+  })
+
+  afterAll(async () => {
+    server.closeAllConnections()
+    await new Promise<void>((resolve) => server.close(() => resolve()))
+  })
+
+  // Resolves when the worker exits, terminating it after terminateAfterMs, if given.
+  function runWorker(
+    options: { url: string; concurrency: number; requests: number },
+    terminateAfterMs?: number,
+  ): Promise<WorkerOutcome> {
+    return new Promise((resolve) => {
+      const outcome: WorkerOutcome = { exitCode: -1, completed: 0, errors: [] }
+      const worker = new Worker(workerSource, {
+        eval: true,
+        workerData: { bindingPath, ...options },
+      })
+
+      worker.on('message', (message) => {
+        if (message.type === 'completed') {
+          outcome.completed++
+        } else if (message.type === 'error') {
+          outcome.errors.push(message.message)
+        } else if (message.type === 'ready' && terminateAfterMs !== undefined) {
+          setTimeout(() => worker.terminate(), terminateAfterMs)
+        }
+      })
+      worker.on('error', (error) => outcome.errors.push(error.message))
+      worker.on('exit', (exitCode) => {
+        outcome.exitCode = exitCode
+        resolve(outcome)
+      })
+    })
+  }
+
+  it(`loads the addon in ${STARTUP_WORKERS} workers at once`, async () => {
+    const outcomes = await Promise.all(
+      Array.from({ length: STARTUP_WORKERS }, () =>
+        runWorker({ url: `${baseUrl}/fast`, concurrency: 2, requests: 5 }),
+      ),
+    )
+
+    for (const outcome of outcomes) {
+      expect(outcome.errors).toEqual([])
+      expect(outcome.exitCode).toBe(0)
+      expect(outcome.completed).toBe(10)
+    }
+  })
+
+  it(
+    `creates and terminates ${WORKERS_PER_WAVE} workers at a time for ${TARGET_DURATION_MS}ms`,
+    async () => {
+      const runWave = () =>
+        Promise.all(
+          Array.from({ length: WORKERS_PER_WAVE }, (_, i) =>
+            i % 2
+              ? // terminated while its transfers are running
+                runWorker(
+                  { url: `${baseUrl}/slow`, concurrency: 8, requests: 1000 },
+                  Math.floor(Math.random() * 100),
+                )
+              : runWorker({
+                  url: `${baseUrl}/fast`,
+                  concurrency: 4,
+                  requests: 10,
+                }),
+          ),
+        )
+
+      // the first wave brings the memory that is only allocated once
+      await runWave()
+      global.gc?.()
+      const rssBefore = process.memoryUsage.rss()
+
+      let waves = 0
+      let completed = 0
+      const errors: string[] = []
+      const deadline = Date.now() + TARGET_DURATION_MS
+
+      while (Date.now() < deadline) {
+        const outcomes = await runWave()
+        waves++
+
+        outcomes.forEach((outcome, i) => {
+          completed += outcome.completed
+          errors.push(...outcome.errors)
+
+          // terminated workers exit with 1
+          expect(outcome.exitCode).toBe(i % 2 ? 1 : 0)
+        })
+      }
+
+      global.gc?.()
+      const rssGrowthMb = (process.memoryUsage.rss() - rssBefore) / 1024 ** 2
+
+      expect(waves).toBeGreaterThan(0)
+      expect(completed).toBeGreaterThan(0)
+      expect(errors, `Errors: ${errors.slice(0, 3).join(' | ')}`).toEqual([])
+      expect(
+        rssGrowthMb,
+        `RSS grew ${rssGrowthMb.toFixed(1)} MB over ${waves} waves of ${WORKERS_PER_WAVE} workers`,
+      ).toBeLessThan(MAX_RSS_GROWTH_MB)
+    },
+    TARGET_DURATION_MS + 60_000,
+  )
+})